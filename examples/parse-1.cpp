@@ -17,15 +17,21 @@ int main(int, char **) {
 
     Word variable {"foo"};
 
-    Block rule {
+    // A ParseRule resolves the words in the rule once, so it's cheap to run
+    // over and over (the `copy` target is left alone, and set on each run).
+    //
+    ParseRule rule {Block {
         "thru {[}",
         "copy", variable, "to {]}",
         "to end"
-    };
+    }};
 
-    auto result = static_cast<Logic>(*runtime("parse", data, rule));
+    // Passing `data` itself would work, but would scan and copy it into a
+    // new STRING! first.  A BorrowedString lets PARSE run on it directly.
+    //
+    BorrowedString input {data};
 
-    if (result)
+    if (rule.matches(input))
         std::cout << "Success and target was " << variable() << "\n";
     else
         std::cout << "PARSE failed.";
@@ -0,0 +1,114 @@
+//
+// completionindex.cpp
+// This file is part of Ren Garden
+// Copyright (C) 2015-2018 MetÆducation
+//
+// Ren Garden is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Ren Garden is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Ren Garden.  If not, see <http://www.gnu.org/licenses/>.
+//
+// See http://ren-garden.metaeducation.com for more information on this project
+//
+
+#include <iterator>
+
+#include "completionindex.h"
+
+using namespace ren;
+
+
+CompletionIndex::CompletionIndex (
+    std::vector<AnyContext> const & contexts,
+    QObject * parent
+) :
+    QObject (parent)
+{
+    for (auto & context : contexts)
+        sources.push_back(Source {context, 0, 0});
+}
+
+
+void CompletionIndex::refresh() {
+    for (size_t index = 0; index < sources.size(); ++index) {
+        Source & source = sources[index];
+
+        // LENGTH OF doesn't copy the words, so checking for growth is cheap
+        // when (as usual) there isn't any
+
+        int length = static_cast<Integer>(
+            *runtime("length of", source.context)
+        );
+        if (length == source.knownLength)
+            continue;
+
+        Block added = static_cast<Block>(*runtime(
+            "copy skip words-of", source.context, source.knownWords
+        ));
+
+        QMutexLocker lock {&wordsMutex};
+
+        for (auto item : added) {
+            QString spelling
+                = static_cast<AnyWord>(item).spellingOf<QString>();
+
+            // An earlier context wins a word it shares with a later one,
+            // even when it only gets the word after the later one did
+            //
+            auto result = words.insert(std::make_pair(
+                spelling.toLower(), Completion {spelling, index}
+            ));
+            if (!result.second && index < result.first->second.contextIndex)
+                result.first->second = Completion {spelling, index};
+            ++source.knownWords;
+        }
+
+        source.knownLength = length;
+    }
+}
+
+
+optional<CompletionIndex::Completion> CompletionIndex::complete(
+    QString const & text,
+    int stemLength,
+    bool backward
+) const {
+    QString stem = text.left(stemLength).toLower();
+    QString current = text.toLower();
+
+    QMutexLocker lock {&wordsMutex};
+
+    // The candidates are the run of keys starting with the stem
+
+    auto first = words.lower_bound(stem);
+    auto last = first;
+    while (last != words.end() && last->first.startsWith(stem))
+        ++last;
+
+    if (first == last)
+        return nullopt;
+
+    auto it = words.find(current);
+    bool isCandidate = it != words.end() && it->first.startsWith(stem);
+
+    if (!backward) {
+        if (!isCandidate)
+            return first->second;
+
+        ++it;
+        return it == last ? first->second : it->second;
+    }
+
+    if (!isCandidate)
+        return std::prev(last)->second;
+
+    return it == first ? std::prev(last)->second : std::prev(it)->second;
+}
@@ -0,0 +1,96 @@
+#ifndef RENGARDEN_COMPLETIONINDEX_H
+#define RENGARDEN_COMPLETIONINDEX_H
+
+//
+// completionindex.h
+// This file is part of Ren Garden
+// Copyright (C) 2015-2018 MetÆducation
+//
+// Ren Garden is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Ren Garden is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Ren Garden.  If not, see <http://www.gnu.org/licenses/>.
+//
+// See http://ren-garden.metaeducation.com for more information on this project
+//
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <QObject>
+#include <QMutex>
+#include <QString>
+
+#include "rencpp/ren.hpp"
+
+
+//
+// COMPLETION INDEX
+//
+
+//
+// Tab completion used to run AUTOCOMPLETE-HELPER on each keystroke, which
+// walks WORDS-OF the tab's context and LIB for every candidate.  That's
+// slow with a big LIB, and it can't be done at all while an evaluation is
+// running (the GUI thread must not call into the runtime then).
+//
+// The index keeps the words of a list of contexts, sorted by spelling, so
+// finding the words with a given prefix is a lookup.  Contexts are given in
+// priority order, and a word in more than one of them is attributed to the
+// first.  refresh() reads only the words a context has gained since the
+// last refresh; it is meant to run on the evaluator thread after each
+// command, and completion can happen on the GUI thread at any time.
+//
+// Words aren't removed, as contexts don't shrink.
+//
+
+class CompletionIndex : public QObject {
+    Q_OBJECT
+
+public:
+    CompletionIndex (
+        std::vector<ren::AnyContext> const & contexts,
+        QObject * parent = nullptr
+    );
+
+    struct Completion {
+        QString spelling;
+        size_t contextIndex; // which of the contexts it's from
+    };
+
+    // With `text` as the whole token and the first `stemLength` characters
+    // of it as the prefix typed so far: if the text is itself a candidate,
+    // gives the one after it (or before it, if backward), otherwise gives
+    // the first.  Wraps around.
+    //
+    ren::optional<Completion> complete(
+        QString const & text, int stemLength, bool backward
+    ) const;
+
+public slots:
+    void refresh();
+
+private:
+    struct Source {
+        ren::AnyContext context;
+        int knownLength;
+        int knownWords;
+    };
+    std::vector<Source> sources;
+
+    // Keyed by lowercase spelling, as words are case-insensitive
+    //
+    std::map<QString, Completion> words;
+    mutable QMutex wordsMutex;
+};
+
+#endif
@@ -55,22 +55,27 @@ void EvaluatorWorker::doWork(
     optional<AnyValue> result;
     bool success = false;
 
+    // Kept outside the `try` so watches can be recalculated even if the
+    // command failed partway, as it may have changed things before failing
+    //
+    optional<Block> loaded;
+
     try {
         // We *always* generate a block to pass to the dialect.  This
         // is Ren Garden, not "arbitrary shell"... so if you want to
         // pass an arbitrary string you must type it in as {49+3hfa} in
         // a properly loadable string.
 
-        auto loaded = context.create<Block>(input.toUtf8().constData());
+        loaded = context.create<Block>(input.toUtf8().constData());
 
         if (meta) {
             if (!runtime("find words-of quote", dialect, "/meta"))
                 throw Error ("current dialect has no /meta refinement");
 
-            result = context(Path {dialect, "meta"}, loaded);
+            result = context(Path {dialect, "meta"}, *loaded);
         }
         else
-            result = context(dialect, loaded);
+            result = context(dialect, *loaded);
 
         success = true;
     }
@@ -145,5 +150,8 @@ void EvaluatorWorker::doWork(
         emit caughtNonRebolException(nullptr);
     }
 
+    if (loaded)
+        emit commandEvaluated(*loaded);
+
     emit resultReady(success, result);
 }
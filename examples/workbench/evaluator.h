@@ -72,6 +72,12 @@ signals:
 
     void initializeDone();
 
+    // Emitted on the evaluator thread with what was evaluated, before the
+    // result is reported.  Connect with Qt::DirectConnection to use the
+    // runtime before the next command can run.
+    //
+    void commandEvaluated(ren::AnyValue const & command);
+
     void caughtNonRebolException(char const * what);
 };
 
@@ -111,6 +111,17 @@ void MainWindow::finishInitializing() {
     auto explorer = new ValueExplorer (dockValueExplorer);
     dockValueExplorer->setWidget(explorer);
 
+    // Pages of a large array are molded on the evaluator thread, since the
+    // explorer can be scrolled while a command is running
+    //
+    connect(
+        explorer, &ValueExplorer::pageRequested,
+        worker, [explorer](ren::AnyValue array, int offset, int generation) {
+            explorer->moldPage(array, offset, generation);
+        },
+        Qt::QueuedConnection
+    );
+
     dockWatch = new QDockWidget(tr("watch"), this);
     dockWatch->setAllowedAreas(
         Qt::LeftDockWidgetArea| Qt::RightDockWidgetArea
@@ -163,6 +174,37 @@ void MainWindow::finishInitializing() {
     addDockWidget(Qt::TopDockWidgetArea, dockValueExplorer);
     dockValueExplorer->hide();
 
+    // The metrics are the same text a monitoring system would scrape.  They
+    // are only atomics to read, so the GUI thread can render them while the
+    // evaluator is busy.
+
+    dockMetrics = new QDockWidget(tr("metrics"), this);
+
+    auto metricsText = new QPlainTextEdit (dockMetrics);
+    metricsText->setReadOnly(true);
+    metricsText->setLineWrapMode(QPlainTextEdit::NoWrap);
+    metricsText->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    dockMetrics->setWidget(metricsText);
+
+    auto metricsTimer = new QTimer {dockMetrics};
+    connect(
+        metricsTimer, &QTimer::timeout,
+        [this, metricsText]() {
+            if (!dockMetrics->isVisible())
+                return;
+
+            int scroll = metricsText->verticalScrollBar()->value();
+            metricsText->setPlainText(
+                QString::fromStdString(ren::metrics.openMetrics())
+            );
+            metricsText->verticalScrollBar()->setValue(scroll);
+        }
+    );
+    metricsTimer->start(1000);
+
+    addDockWidget(Qt::RightDockWidgetArea, dockMetrics);
+    dockMetrics->hide();
+
     createActions();
     createMenus();
     createStatusBar();
@@ -193,6 +235,12 @@ void MainWindow::finishInitializing() {
         Qt::DirectConnection
     );
 
+    connect(
+        dockMetrics, &QDockWidget::visibilityChanged,
+        metricsAct, &QAction::setChecked,
+        Qt::DirectConnection
+    );
+
     readSettings();
 
     show();
@@ -370,6 +418,15 @@ void MainWindow::createActions()
         }
     );
 
+    metricsAct = new QAction(tr("&Metrics"), this);
+    metricsAct->setCheckable(true);
+    connect(
+        metricsAct, &QAction::triggered,
+        [this](bool checked) {
+            dockMetrics->setVisible(checked);
+        }
+    );
+
     aboutAct = new QAction(tr("&About"), this);
     aboutAct->setStatusTip(tr("Show the application's About box"));
     connect(
@@ -404,6 +461,7 @@ void MainWindow::createMenus()
     windowMenu->addSeparator();
     windowMenu->addAction(watchListAct);
     windowMenu->addAction(valueExplorerAct);
+    windowMenu->addAction(metricsAct);
 
     languageMenu = menuBar()->addMenu(tr("&Language"));
     languageMenu->addAction(proposalsAct);
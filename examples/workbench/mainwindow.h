@@ -91,6 +91,7 @@ public:
     RenConsole * console;
     QDockWidget * dockWatch;
     QDockWidget * dockValueExplorer;
+    QDockWidget * dockMetrics;
 
 private:
     QAction * separatorAct;
@@ -113,6 +114,7 @@ private:
     QAction * closeTabAct;
     QAction * watchListAct;
     QAction * valueExplorerAct;
+    QAction * metricsAct;
 
     QMenu * helpMenu;
     QAction * aboutAct;
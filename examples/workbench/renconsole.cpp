@@ -54,6 +54,7 @@ RenConsole::RenConsole (EvaluatorWorker * worker, QWidget * parent) :
     libContext (static_cast<AnyContext>(*runtime("system/contexts/lib"))),
     shell (),
     bannerPrinted (false),
+    worker (worker),
     evaluatingRepl (nullptr),
     proposalsContext (), // we will copy it from userContext when ready...
     useProposals (true)
@@ -428,6 +429,11 @@ RenConsole::RenConsole (EvaluatorWorker * worker, QWidget * parent) :
     //
     shell.reset(new RenShell(*helpersContext));
 
+    // Runs one program directly, for scripts that want its output and exit
+    // status rather than the shell dialect's printing
+    //
+    Function callProcess = Subprocess::function();
+
     // make it possible to get at the proposals context from both user
     // and proposals, and also install the console extensions in both
     //
@@ -439,6 +445,7 @@ RenConsole::RenConsole (EvaluatorWorker * worker, QWidget * parent) :
 
             "console: quote", consoleFunction,
             "shell: quote", shell->getShellDialectFunction(),
+            "call-process: quote", callProcess,
             "watch: quote", watchFunction,
 
             // A bit too easy to overwrite them, e.g. `console: :shell`
@@ -490,7 +497,8 @@ void RenConsole::createNewTab() {
             static_cast<Function>(consoleFunction),
             (count() > 0) ? nullopt : optional<Tag>{Tag {"&Main"}},
             context,
-            new WatchList (nullptr)
+            new WatchList (nullptr),
+            new CompletionIndex ({context, libContext})
         }
     ));
 
@@ -502,9 +510,52 @@ void RenConsole::createNewTab() {
         Qt::DirectConnection
     );
 
+    // Watches are recalculated on the evaluator thread right after each
+    // command, and only those the command could have affected.  The table
+    // is then repainted on the GUI thread.
+    //
+    connect(
+        worker, &EvaluatorWorker::commandEvaluated,
+        (emplacement.first)->second.watchList, &WatchList::recalculate,
+        Qt::DirectConnection
+    );
+
     connect(
-        this, &RenConsole::finishedEvaluation,
+        (emplacement.first)->second.watchList, &WatchList::recalculated,
         (emplacement.first)->second.watchList, &WatchList::updateAllWatchers,
+        Qt::QueuedConnection
+    );
+
+    // Toggling a watch's freeze or recalculation from the GUI asks for it to
+    // be recalculated, and editing its name asks for a new label.  Those
+    // happen on the evaluator thread too, since the worker object is the
+    // context for the calls.
+    //
+    WatchList * watchList = (emplacement.first)->second.watchList;
+    connect(
+        watchList, &WatchList::recalculationRequested,
+        worker, [watchList](int index) {
+            watchList->recalculateWatcher(index);
+        },
+        Qt::QueuedConnection
+    );
+
+    connect(
+        watchList, &WatchList::relabelRequested,
+        worker, [watchList](int index, QString contents) {
+            watchList->relabelWatcher(index, contents);
+        },
+        Qt::QueuedConnection
+    );
+
+    // New words are added to the completion index on the evaluator thread,
+    // so tab completion never has to wait for (or call) the evaluator.
+    //
+    (emplacement.first)->second.completions->refresh();
+
+    connect(
+        worker, &EvaluatorWorker::commandEvaluated,
+        (emplacement.first)->second.completions, &CompletionIndex::refresh,
         Qt::DirectConnection
     );
 
@@ -550,6 +601,7 @@ void RenConsole::tryCloseTab(int index) {
     removeTab(index);
     delete pad;
     delete it->second.watchList;
+    delete it->second.completions;
     tabinfos.erase(it);
 
     repl().setFocus();
@@ -867,62 +919,32 @@ void RenConsole::handleResults(
 // threads independently.
 //
 
-std::pair<int, int> RenConsole::rangeForWholeToken(
-    QString buffer, int offset
+std::vector<std::pair<int, int>> RenConsole::tokenizeLine(
+    QString const & line
 ) const {
-    if (buffer.isEmpty())
-        return std::make_pair(0, 0);
-
-    // Took a shot at using PARSE instead of the RegEx.  This code snippet
-    // does not currently work, however.  Two reasons:
-    //
-    //     >> parse "abb" [copy x thru ["a" any "b"] (print x)]
-    //     "a"
-    //     == false
-    //
-    // That should return "abb".  (In Red it does.)  Also, it complains
-    // about the `negate ws` charset being used in the position it is
-    // as a "parse error"
-
-#ifdef REBOL_PARSE_FOR_AUTOCOMPLETE
-    auto blk = static_cast<Block>(runtime(
-        "wrap", Block {
-            "ws: whitespace/ascii "
-            "sym: negate ws " // why not negate ws?
-            "do", Block {
-                "parse", String {leading}, "[ "
-                    "(pos: 0) "
-                    "any [ws (++ pos)] "
-                    "some [ "
-                        "copy stem thru [ "
-                            "sym (start: pos) "
-                            "any [sym (++ pos)] "
-                        "] "
-                    "] "
-                    "(finish: pos) "
-                "] "
-             },
-            "probe reduce [start finish] "
-        }
-    ));
-
-    assert(blk[1].isInteger());
-    assert(blk[2].isInteger());
-
-    int start = static_cast<Integer>(blk[1]);
-    int finish = static_cast<Integer>(blk[2]);
-#else
-    int start = buffer.lastIndexOf(QRegExp {"[\\s][^\\s]"}, offset);
-    if (start == -1)
-        start = 0;
-    else
-        start++;
-    int finish = buffer.indexOf(QRegExp {"[^\\s][\\s]"}, offset);
-    if (finish == -1)
-        finish = buffer.length();
-#endif
+    // !!! Tokens are just runs of non-whitespace for now.  Using PARSE was
+    // tried, but the GUI thread can't call the evaluator while it's busy,
+    // and this gets called as the user types.  What's needed is a scanner
+    // that knows about strings in braces and such.
+
+    std::vector<std::pair<int, int>> tokens;
+
+    int length = line.length();
+    int pos = 0;
+    while (pos < length) {
+        while (pos < length && line[pos].isSpace())
+            ++pos;
+        if (pos == length)
+            break;
+
+        int start = pos;
+        while (pos < length && !line[pos].isSpace())
+            ++pos;
+
+        tokens.emplace_back(start, pos);
+    }
 
-    return std::make_pair(start, finish);
+    return tokens;
 }
 
 
@@ -936,7 +958,44 @@ std::pair<QString, int> RenConsole::autoComplete(
     // for other finding.  DocKimbel has suggested that Red's contexts
     // may not have any complex hierarchy, so more understanding is needed
 
-    Block contexts {getTabInfo(repl()).context, libContext};
+    TabInfo & info = getTabInfo(repl());
+
+    // Plain words are completed from the index.  Paths (fields of objects,
+    // refinements of functions) are interpreted by the helper, which needs
+    // the evaluator.
+
+    if (!text.contains('/')) {
+        if (index == 0)
+            return std::make_pair(text, index); // no stem to complete
+
+        optional<CompletionIndex::Completion> completion
+            = info.completions->complete(text, index, backward);
+
+        if (completion == nullopt)
+            return std::make_pair(text, index);
+
+        // Showing HELP for it runs code, so only do so if nothing else is
+
+        if (!evaluatingRepl) {
+            AnyContext context = completion->contextIndex == 0
+                ? info.context
+                : libContext;
+
+            emit exploreValue(
+                *(*proposalsContext)(":help"),
+                Word {completion->spelling, context}
+            );
+        }
+
+        return std::make_pair(completion->spelling, index);
+    }
+
+    if (evaluatingRepl) {
+        emit reportStatus(tr("Can't complete paths during an evaluation"));
+        return std::make_pair(text, index);
+    }
+
+    Block contexts {info.context, libContext};
 
     optional<Block> completion;
 
@@ -35,6 +35,7 @@
 #include "renshell.h"
 #include "renpackage.h"
 #include "watchlist.h"
+#include "completionindex.h"
 
 class MainWindow;
 
@@ -49,8 +50,8 @@ public:
 
 private:
     // Syntax highlighting hooks
-    std::pair<int, int> rangeForWholeToken(
-        QString buffer, int offset
+    std::vector<std::pair<int, int>> tokenizeLine(
+        QString const & line
     ) const override;
 
     std::pair<QString, int> autoComplete(
@@ -84,6 +85,7 @@ private:
         ren::optional<ren::Tag> label; // label of the tab
         ren::AnyContext context;
         WatchList * watchList;
+        CompletionIndex * completions; // words of `context` and LIB
     };
 
     std::unordered_map<ReplPad const *, TabInfo> tabinfos;
@@ -115,6 +117,7 @@ protected:
     bool isReadyToModify(ReplPad & pad, bool escaping) override;
 
 private:
+    EvaluatorWorker * worker;
     ReplPad * evaluatingRepl;
     NulOStream nulOstream;
 
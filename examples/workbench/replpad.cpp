@@ -30,6 +30,22 @@
 #include "replpad.h"
 
 
+namespace {
+
+// Output from other threads is put into the document at most this often,
+// which is about once per frame.
+//
+const int flushIntervalMsec = 16;
+
+// Past this many characters, old history entries (and then the oldest
+// output of the command that's running) are removed.  It's trimmed down to
+// 3/4 of this so it doesn't happen on every flush.
+//
+const int maxScrollback = 4 * 1024 * 1024;
+
+} // end anonymous namespace
+
+
 
 //
 // HISTORY RECORDS
@@ -80,6 +96,9 @@ ReplPad::ReplPad (
     syntaxer (syntaxer),
     fakeOut (*this),
     fakeIn (*this),
+    pendingLength (0),
+    flushRequested (false),
+    flushTimer (),
     defaultFont (currentFont()),
     zoomDelta (0),
     shouldFollow (true),
@@ -186,13 +205,23 @@ ReplPad::ReplPad (
     );
 
     // We want to be able to append text from threads besides the GUI thread.
-    // It is a synchronous operation for a worker, but still goes through the
-    // emit process.
+    // Laying out the document for each chunk a script PRINTs is very slow,
+    // so the worker doesn't wait on it.  Text is collected and flushed on a
+    // timer, see appendText().
+
+    flushTimer.setSingleShot(true);
+    flushTimer.setInterval(flushIntervalMsec);
 
     connect(
-        this, &ReplPad::needGuiThreadTextAppend,
-        this, &ReplPad::appendText,
-        Qt::BlockingQueuedConnection
+        &flushTimer, &QTimer::timeout,
+        this, &ReplPad::flushPendingText,
+        Qt::DirectConnection
+    );
+
+    connect(
+        this, &ReplPad::needGuiThreadFlush,
+        this, &ReplPad::scheduleFlush,
+        Qt::QueuedConnection
     );
 
     connect(
@@ -302,6 +331,8 @@ void ReplPad::appendImage(QImage const & image, bool centered) {
         return;
     }
 
+    flushPendingText();
+
     QMutexLocker lock {&documentMutex};
 
     QTextCursor cursor = endCursor();
@@ -318,15 +349,70 @@ void ReplPad::appendImage(QImage const & image, bool centered) {
 
 void ReplPad::appendText(QString const & text, bool centered) {
     if (thread() != QThread::currentThread()) {
-        //
-        // we need to block in order to properly check for write mutex
-        // authority (otherwise we could just queue it and split...)
-        // just calls this function again but from the Gui Thread
-        //
-        emit needGuiThreadTextAppend(text, centered);
+        QMutexLocker lock {&pendingMutex};
+
+        if (!pendingTexts.empty() && pendingTexts.back().centered == centered)
+            pendingTexts.back().text += text;
+        else
+            pendingTexts.push_back(PendingText {text, centered});
+
+        pendingLength += text.size();
+
+        // If the GUI can't keep up, text that would be trimmed from the
+        // scrollback as soon as it was inserted is dropped here instead.
+
+        while (pendingLength > maxScrollback && pendingTexts.size() > 1) {
+            pendingLength -= pendingTexts.front().text.size();
+            pendingTexts.erase(pendingTexts.begin());
+        }
+        if (pendingLength > maxScrollback) {
+            int excess = pendingLength - maxScrollback;
+            pendingTexts.front().text.remove(0, excess);
+            pendingLength -= excess;
+        }
+
+        // One flush request covers everything appended until it runs
+
+        if (!flushRequested) {
+            flushRequested = true;
+            emit needGuiThreadFlush();
+        }
         return;
     }
 
+    flushPendingText(); // so it comes after text from other threads
+    insertText(text, centered);
+    trimScrollback();
+}
+
+
+void ReplPad::scheduleFlush() {
+    if (!flushTimer.isActive())
+        flushTimer.start();
+}
+
+
+void ReplPad::flushPendingText() {
+    std::vector<PendingText> texts;
+
+    {
+        QMutexLocker lock {&pendingMutex};
+        texts.swap(pendingTexts);
+        pendingLength = 0;
+        flushRequested = false;
+    }
+
+    if (texts.empty())
+        return;
+
+    for (auto & pending : texts)
+        insertText(pending.text, pending.centered);
+
+    trimScrollback();
+}
+
+
+void ReplPad::insertText(QString const & text, bool centered) {
     QMutexLocker lock {&documentMutex};
 
     QTextCursor cursor = endCursor();
@@ -366,6 +452,8 @@ void ReplPad::appendHtml(QString const & html, bool centered) {
         return;
     }
 
+    flushPendingText();
+
     QMutexLocker lock {&documentMutex};
 
     QTextCursor cursor = endCursor();
@@ -446,6 +534,61 @@ QTextCursor ReplPad::endCursor() const {
 }
 
 
+//
+// ReplPad::tokensOf()
+//
+// Tokens of a line, from the cache in the block's user data if it hasn't been
+// edited since.  So a keystroke only causes the line it's on to be scanned
+// again, however long the input is.
+//
+std::vector<std::pair<int, int>> const & ReplPad::tokensOf(QTextBlock block) {
+    auto data = static_cast<TokenData *>(block.userData());
+
+    if (
+        data
+        && data->revision == block.revision()
+        && data->length == block.length()
+    ){
+        return data->tokens;
+    }
+
+    if (!data) {
+        data = new TokenData;
+        block.setUserData(data); // the block takes ownership
+    }
+
+    data->revision = block.revision();
+    data->length = block.length();
+    data->tokens = syntaxer.tokenizeLine(block.text());
+
+    return data->tokens;
+}
+
+
+std::pair<int, int> ReplPad::rangeForWholeToken(int position) {
+    QTextBlock block = document()->findBlock(position);
+    int offset = position - block.position();
+
+    auto const & tokens = tokensOf(block);
+
+    // First token not ending before the position
+    //
+    auto it = std::lower_bound(
+        tokens.begin(), tokens.end(), offset,
+        [](std::pair<int, int> const & token, int offset) {
+            return token.second < offset;
+        }
+    );
+
+    if (it == tokens.end() || it->first > offset)
+        return std::make_pair(position, position);
+
+    return std::make_pair(
+        block.position() + it->first, block.position() + it->second
+    );
+}
+
+
 void ReplPad::dontFollowLatestOutput() {
     shouldFollow = false;
 }
@@ -457,6 +600,77 @@ void ReplPad::followLatestOutput() {
 }
 
 
+void ReplPad::trimScrollback() {
+    if (document()->characterCount() <= maxScrollback || history.empty())
+        return;
+
+    int excess = document()->characterCount() - (maxScrollback / 4) * 3;
+
+    QMutexLocker lock {&documentMutex};
+
+    // Remove whole history entries first, oldest first.  The last entry is
+    // the one being edited or evaluated, so it is kept.
+
+    size_t dropped = 0;
+    int cut = 0;
+    while (dropped + 1 < history.size() && cut < excess) {
+        ++dropped;
+        cut = history[dropped].promptPos;
+    }
+
+    if (cut > 0) {
+        QTextCursor cursor {document()};
+        cursor.setPosition(0, QTextCursor::MoveAnchor);
+        cursor.setPosition(cut, QTextCursor::KeepAnchor);
+        cursor.removeSelectedText();
+
+        history.erase(history.begin(), history.begin() + dropped);
+
+        for (auto & entry : history) {
+            entry.promptPos -= cut;
+            entry.inputPos -= cut;
+            if (entry.endPos)
+                *entry.endPos -= cut;
+        }
+
+        if (historyIndex) {
+            if (*historyIndex < dropped)
+                historyIndex = std::experimental::nullopt;
+            else
+                historyIndex = *historyIndex - dropped;
+        }
+
+        excess -= cut;
+    }
+
+    // One command can print more than the whole limit.  Then the oldest
+    // lines of its output go, leaving its prompt and input alone.
+
+    HistoryEntry & last = history.back();
+    if (excess > 0 && last.endPos) {
+        QTextBlock first = document()->findBlock(*last.endPos).next();
+        if (first.isValid()) {
+            int from = first.position();
+            int to = document()->findBlock(from + excess).position();
+
+            if (to > from) {
+                QTextCursor cursor {document()};
+                cursor.setPosition(from, QTextCursor::MoveAnchor);
+                cursor.setPosition(to, QTextCursor::KeepAnchor);
+                cursor.removeSelectedText();
+            }
+        }
+    }
+
+    // Undo would restore text at positions that have moved
+
+    document()->clearUndoRedoStacks();
+
+    if (shouldFollow)
+        verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+}
+
+
 void ReplPad::mousePressEvent(QMouseEvent * event) {
 
     if (event->buttons() == Qt::RightButton) {
@@ -503,17 +717,16 @@ void ReplPad::mouseDoubleClickEvent(QMouseEvent * event) {
     }
 
     if (entryInside) {
-        std::pair<int, int> range = syntaxer.rangeForWholeToken(
-            entryInside->getInput(*this),
-            textCursor().position() - entryInside->inputPos
+        std::pair<int, int> range = rangeForWholeToken(
+            textCursor().position()
         );
 
+        // The prompt is on the same line as the input, so don't let the
+        // token start before the input does
+
         QTextCursor cursor {document()};
-        cursor.setPosition(range.first + entryInside->inputPos);
-        cursor.setPosition(
-            range.second + entryInside->inputPos,
-            QTextCursor::KeepAnchor
-        );
+        cursor.setPosition(std::max(range.first, entryInside->inputPos));
+        cursor.setPosition(range.second, QTextCursor::KeepAnchor);
         setTextCursor(cursor);
     } else {
         QTextEdit::mouseDoubleClickEvent(event);
@@ -522,6 +735,8 @@ void ReplPad::mouseDoubleClickEvent(QMouseEvent * event) {
 
 
 void ReplPad::pushFormat(QTextCharFormat const & format) {
+    flushPendingText(); // the format is for the text that comes next
+
     isFormatPending = true;
     pendingFormat = format;
 }
@@ -535,6 +750,8 @@ void ReplPad::pushFormat(QTextCharFormat const & format) {
 //
 void ReplPad::appendNewPrompt() {
 
+    flushPendingText();
+
     // This initializes a new history entry, which also rewrites the
     // prompt -- capturing the position before and after the prompt text
 
@@ -1343,41 +1560,37 @@ void ReplPad::keyPressEvent(QKeyEvent * event) {
             return;
         }
 
-        // Ask the syntaxer to find the range of the current token.
+        // Find the range of the current token, which only looks at the line
+        // the cursor is on.
 
-        QString input = entry.getInput(*this);
-        auto tokenRange = syntaxer.rangeForWholeToken(
-            input, cursor.position() - entry.inputPos
-        );
+        auto tokenRange = rangeForWholeToken(cursor.position());
+        tokenRange.first = std::max(tokenRange.first, entry.inputPos);
 
-        QString incomplete = input.mid(
-            tokenRange.first, tokenRange.second - tokenRange.first
-        );
+        QTextCursor tokenCursor {document()};
+        tokenCursor.setPosition(tokenRange.first);
+        tokenCursor.setPosition(tokenRange.second, QTextCursor::KeepAnchor);
+
+        QString incomplete = tokenCursor.selectedText();
 
         auto completed = syntaxer.autoComplete(
             incomplete,
-            cursor.position() - entry.inputPos - tokenRange.first,
+            cursor.position() - tokenRange.first,
             key == Qt::Key_Backtab
         );
 
         // Replace the token with the new token text from the completer
 
         QMutexLocker lock {&documentMutex};
-        cursor.setPosition(entry.inputPos + tokenRange.first);
-        cursor.setPosition(
-            entry.inputPos + tokenRange.second,
-            QTextCursor::KeepAnchor
-        );
+        cursor.setPosition(tokenRange.first);
+        cursor.setPosition(tokenRange.second, QTextCursor::KeepAnchor);
         cursor.insertText(completed.first);
 
         // Make a selection of the completed portion, as told to us by the
         // index reported back from the comletion
 
+        cursor.setPosition(tokenRange.first + completed.second);
         cursor.setPosition(
-            entry.inputPos + tokenRange.first + completed.second
-        );
-        cursor.setPosition(
-            entry.inputPos + tokenRange.first + completed.first.length(),
+            tokenRange.first + completed.first.length(),
             QTextCursor::KeepAnchor
         );
         setTextCursor(cursor);
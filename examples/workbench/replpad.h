@@ -28,7 +28,9 @@
 #include "optional/optional.hpp"
 
 #include <QTextEdit>
+#include <QTextBlock>
 #include <QElapsedTimer>
+#include <QTimer>
 #include <QWaitCondition>
 #include <QMutex>
 
@@ -54,20 +56,25 @@ class ReplPad;
 
 class IReplPadSyntaxer {
 public:
-    // rangeForWholeToken() means that if | represents your cursor and you had:
+    // tokenizeLine() splits one line of the console into tokens, as
+    // [start, end) offsets in order.  If | represents your cursor and you
+    // had:
     //
     //     print {Hello| World}
     //
-    // Then the offset would realize you wanted to select from opening curly
-    // brace to the closing curly brace, vs merely selecting hello (as a
-    // default text edit might.)
+    // Then the tokens should let the ReplPad realize you wanted to select
+    // from opening curly brace to the closing curly brace, vs merely
+    // selecting hello (as a default text edit might.)
+    //
+    // The ReplPad caches the tokens of each line until it is edited, so this
+    // is only called again for lines that changed.
 
-    virtual std::pair<int, int> rangeForWholeToken(
-        QString buffer, int offset
+    virtual std::vector<std::pair<int, int>> tokenizeLine(
+        QString const & line
     ) const = 0;
 
     // Beginnings of a basic auto completion (e.g. with tab) interface.  It
-    // is similar to rangeForWholeToken, but assumes you are asking for a
+    // is given the token the cursor is in, and assumes you are asking for a
     // completion of token where the cursor is sitting at the index position
     // (there may be text after the token, such as from a previous completion)
 
@@ -143,7 +150,7 @@ private:
     QByteArray input; // as utf-8
 
 signals:
-    void needGuiThreadTextAppend(QString text, bool centered);
+    void needGuiThreadFlush();
     void needGuiThreadHtmlAppend(QString html, bool centered);
     void needGuiThreadImageAppend(QImage image, bool centered);
 public:
@@ -151,6 +158,28 @@ public:
     void appendText(QString const & text, bool centered = false);
     void appendHtml(QString const & html, bool centered = false);
 
+private:
+    // Text appended from other threads (e.g. by a script's PRINTs) is
+    // collected here, and put in the document at most once per flush
+    // interval instead of once per append.
+    //
+    struct PendingText {
+        QString text;
+        bool centered;
+    };
+    QMutex pendingMutex;
+    std::vector<PendingText> pendingTexts;
+    int pendingLength;
+    bool flushRequested;
+    QTimer flushTimer;
+
+    void insertText(QString const & text, bool centered);
+    void trimScrollback();
+
+private slots:
+    void scheduleFlush();
+    void flushPendingText();
+
 private slots:
     void onRequestInput();
 
@@ -193,6 +222,21 @@ private:
     bool shouldFollow;
     bool isFormatPending;
     QTextCursor endCursor() const;
+
+    // Token boundaries of each line are kept in the QTextBlock's user data,
+    // and recomputed only when the block's revision says it was edited.
+    //
+    struct TokenData : public QTextBlockUserData {
+        int revision;
+        int length;
+        std::vector<std::pair<int, int>> tokens;
+    };
+    std::vector<std::pair<int, int>> const & tokensOf(QTextBlock block);
+
+    // Document positions of the token at (or ending at) the position, or an
+    // empty range at the position if it's in whitespace
+    //
+    std::pair<int, int> rangeForWholeToken(int position);
     QTextCharFormat pendingFormat;
 public:
     void pushFormat(QTextCharFormat const & format);
@@ -19,19 +19,117 @@
 // See http://ren-garden.metaeducation.com for more information on this project
 //
 
+#include <algorithm>
 #include <sstream>
 
 #include <QMessageBox>
+#include <QScrollBar>
 
 #include "valueexplorer.h"
 
 using namespace ren;
 
+namespace {
+
+const size_t itemsPerPage = 100;
+
+} // end anonymous namespace
+
+
 ValueExplorer::ValueExplorer (QWidget * parent) :
-    QPlainTextEdit (parent)
+    QPlainTextEdit (parent),
+    pagedLength (0),
+    pagedOffset (0),
+    generation (0),
+    paging (false),
+    appending (false)
 {
     setReadOnly(true);
     zoomOut(); // make slightly smaller than normal?  :-/
+
+    connect(
+        verticalScrollBar(), &QScrollBar::valueChanged,
+        this, &ValueExplorer::onScrolled,
+        Qt::DirectConnection
+    );
+
+    connect(
+        this, &ValueExplorer::pageMolded,
+        this, &ValueExplorer::appendPage,
+        Qt::QueuedConnection // emitted on the evaluator thread
+    );
+}
+
+
+void ValueExplorer::requestPage() {
+    paging = true;
+    emit pageRequested(
+        *pagedArray, static_cast<int>(pagedOffset), generation
+    );
+}
+
+
+void ValueExplorer::moldPage(
+    AnyValue const & array,
+    int offset,
+    int forGeneration
+) {
+    MoldLimits limits;
+    limits.maxBytes = 64 * 1024; // in case the items themselves are huge
+    limits.maxDepth = 4;
+
+    AnyArray items = static_cast<AnyArray>(array);
+    size_t end = std::min(
+        static_cast<size_t>(offset) + itemsPerPage, items.length()
+    );
+
+    QString text;
+    for (size_t index = static_cast<size_t>(offset); index < end; ++index) {
+        std::string molded = moldRange(items, index, 1, limits).text;
+        if (index != static_cast<size_t>(offset))
+            text += '\n';
+        text += QString::fromUtf8(
+            molded.data(), static_cast<int>(molded.size())
+        );
+    }
+
+    emit pageMolded(text, static_cast<int>(end), forGeneration);
+}
+
+
+void ValueExplorer::appendPage(
+    QString const & text,
+    int end,
+    int forGeneration
+) {
+    if (forGeneration != generation)
+        return; // molded for a value that has since been replaced
+
+    paging = false;
+
+    // The view is put back where it was, so the user scrolls on into the
+    // new page instead of being taken to the end of it
+
+    int position = verticalScrollBar()->value();
+    appending = true;
+
+    appendPlainText(text);
+    pagedOffset = static_cast<size_t>(end);
+
+    verticalScrollBar()->setValue(position);
+    appending = false;
+}
+
+
+void ValueExplorer::onScrolled(int position) {
+    if (appending || paging || !pagedArray)
+        return;
+
+    if (position < verticalScrollBar()->maximum())
+        return;
+
+    if (pagedOffset < pagedLength)
+        requestPage();
 }
 
 
@@ -42,9 +140,27 @@ void ValueExplorer::setValue(
     if (!this->isVisible())
         return;
 
+    pagedArray = nullopt;
+    pagedLength = 0;
+    pagedOffset = 0;
+    ++generation;
+    paging = false;
+
     if (value == nullopt) {
         document()->setPlainText("");
     }
+    else if (
+        hasType<AnyArray>(value)
+        && static_cast<AnyArray>(*value).length() > itemsPerPage
+    ) {
+        pagedArray = static_cast<AnyArray>(*value);
+        pagedLength = pagedArray->length();
+
+        document()->setPlainText(
+            QString("; %1 items, one per line").arg(pagedLength)
+        );
+        requestPage();
+    }
     else {
         try {
             std::stringstream ss;
@@ -34,15 +34,50 @@ class ValueExplorer : public QPlainTextEdit {
 private:
     ren::optional<ren::AnyValue> value;
 
+    // Large arrays aren't given to HELP, which would mold all of them.
+    // They're molded a page at a time as the user scrolls to the end.  The
+    // molding is done on the evaluator thread, as the user can scroll while
+    // a command is running.
+    //
+    ren::optional<ren::AnyArray> pagedArray;
+    size_t pagedLength;
+    size_t pagedOffset;
+
+    int generation; // changed with each new value, so stale pages are dropped
+    bool paging; // a page was asked for and hasn't arrived yet
+
+    // Appending text moves the scroll bar, which would call onScrolled()
+    // (and so ask for another page) again in the middle of appending
+    //
+    bool appending;
+
+    void requestPage();
+
 public:
     ValueExplorer (QWidget * parent);
     ~ValueExplorer () override;
 
+    // Called on the evaluator thread, and touches none of the widget's state
+    //
+    void moldPage(ren::AnyValue const & array, int offset, int generation);
+
+signals:
+    // Connected (queued) to run moldPage() on the evaluator thread
+    //
+    void pageRequested(ren::AnyValue array, int offset, int generation);
+
+    void pageMolded(QString text, int end, int generation);
+
 public slots:
     void setValue(
         ren::AnyValue const & helpFunction,
         ren::optional<ren::AnyValue> const & value
     );
+
+private slots:
+    void onScrolled(int position);
+
+    void appendPage(QString const & text, int end, int generation);
 };
 
 #endif
@@ -22,6 +22,7 @@
 #include <cstdlib>  // std::abs for integers
 #include <iterator>
 #include <stdexcept>
+#include <utility>
 
 #include <QtWidgets>
 #include <QTableWidget>
@@ -62,32 +63,34 @@ QSize WatchList::sizeHint() const {
 //
 
 void WatchList::onItemChanged(QTableWidgetItem * item) {
-    Watcher & w = *watchers[item->row()];
+    int index = item->row() + 1;
 
     switch (item->column()) {
         case 0: {
             QString contents = item->data(Qt::DisplayRole).toString();
 
-            if (contents == w.getWatchString()) {
-                //
-                // If the text is the same as what it was, then odds are they
-                // selected in the cell and clicked away...vs having the
-                // expression (x + y) and wanting to label it (x + y), for
-                // instance.
-                //
-                return;
+            {
+                QMutexLocker lock {&watchersMutex};
+                if (contents == watchers[index - 1]->getWatchString()) {
+                    //
+                    // If the text is the same as what it was, then odds are
+                    // they selected in the cell and clicked away...vs having
+                    // the expression (x + y) and wanting to label it (x + y),
+                    // for instance.
+                    //
+                    return;
+                }
             }
 
             // If they type text into the first column and it doesn't match
             // text that was there, then consider it to be a label.  If they
             // delete everything, consider it to be "unlabeling"
             //
-            if (contents.isEmpty())
-                w.label = nullopt;
-            else
-                w.label = Tag {contents};
-
-            updateWatcher(item->row() + 1);
+            // The TAG! is made on the evaluator thread, which then has the
+            // row repainted.  The label doesn't affect the value, so the
+            // watch isn't evaluated again.
+            //
+            emit relabelRequested(index, contents);
             break;
         }
 
@@ -104,6 +107,126 @@ void WatchList::onItemChanged(QTableWidgetItem * item) {
 
 
 
+//
+// FOOTPRINTS OF WATCHES AND COMMANDS
+//
+
+//
+// Recalculating every watch after every command makes the console stall
+// when there are many watches, so a watch is only recalculated if the
+// command could have changed something the watch reads.  Neither is run to
+// find that out; they're scanned for the words they mention.
+//
+// A command "writes" any word it mentions (it may be a SET-WORD!, or handed
+// to APPEND, or...), and a watch "reads" any word it mentions.  That misses
+// three things, which are handled conservatively:
+//
+// * Series and objects can be reached through more than one word, so if both
+//   the command and the watch mention one then they are assumed to overlap.
+//
+// * A function the user wrote can read or write any variable, so calling one
+//   makes a footprint "opaque", and it overlaps with everything.
+//
+// * So can the natives that take code or words as values (DO, GET, SET...).
+//
+// !!! Words are matched by spelling and not by binding, so a watch can be
+// recalculated when a same-named variable in another context changes.
+//
+
+namespace {
+
+char const * const evaluatingNatives[] = {
+    "do", "reduce", "compose", "apply", "eval", "get", "set", "bind", "use"
+};
+
+const int maxFootprintDepth = 32; // arrays can contain themselves
+
+
+void noteWord(AnyWord const & word, WatchList::Footprint & footprint) {
+    QString spelling = word.spellingOf<QString>().toLower();
+    footprint.words.insert(spelling);
+
+    if (
+        !hasType<Word>(word) && !hasType<GetWord>(word)
+        && !hasType<SetWord>(word) && !hasType<LitWord>(word)
+    ) {
+        return; // refinements and issues aren't variables
+    }
+
+    Evaluation fetched = runtime.tryEvaluate({"get/opt quote", word});
+    if (fetched.status != Evaluation::Status::Completed || !fetched.value)
+        return;
+
+    AnyValue const & value = *fetched.value;
+
+    if (hasType<AnySeries>(value) || hasType<AnyContext>(value)) {
+        footprint.touchesSeries = true;
+        return;
+    }
+
+    if (!hasType<Function>(value))
+        return;
+
+    for (char const * native : evaluatingNatives) {
+        if (spelling == native) {
+            footprint.opaque = true;
+            return;
+        }
+    }
+
+    // Anything else that isn't what LIB has under that name is taken to be
+    // a function of the user's
+
+    Evaluation inLib = runtime.tryEvaluate({"select lib quote", word});
+    if (!inLib.value || !inLib.value->isSameAs(value))
+        footprint.opaque = true;
+}
+
+
+void collectFootprint(
+    AnyValue const & code,
+    WatchList::Footprint & footprint,
+    int depth
+) {
+    if (depth > maxFootprintDepth) {
+        footprint.opaque = true;
+        return;
+    }
+
+    ren::visit(code, overloaded(
+        [&](AnyWord const & word) {
+            noteWord(word, footprint);
+        },
+        [&](AnyArray const & array) {
+            for (auto item : array)
+                collectFootprint(item, footprint, depth + 1);
+        },
+        [&](AnyValue const &) {}
+    ));
+}
+
+} // end anonymous namespace
+
+
+WatchList::Footprint WatchList::Footprint::of(AnyValue const & code) {
+    Footprint footprint;
+    collectFootprint(code, footprint, 0);
+    return footprint;
+}
+
+
+bool WatchList::Footprint::mayAffect(Footprint const & reads) const {
+    if (opaque || reads.opaque)
+        return true;
+
+    if (touchesSeries && reads.touchesSeries)
+        return true;
+
+    return words.intersects(reads.words);
+}
+
+
+
 //
 // WATCHER CLASS REPRESENTING A SINGLE WATCHED VALUE OR EXPRESSION
 //
@@ -118,61 +241,99 @@ WatchList::Watcher::Watcher (
     label (label),
     frozen (false)
 {
+    // Formed here, on the thread that may use the runtime, for the GUI to
+    // paint.  The watch itself never changes.
+    //
+    watchString = to_QString(watch);
+    if (label)
+        labelString = label->spellingOf<QString>();
+
     evaluate(true);
 }
 
 
 void WatchList::Watcher::evaluate(bool firstTime) {
+    if (firstTime || (recalculates && !frozen))
+        store(calculate());
+}
+
+
+WatchList::Watcher::Result WatchList::Watcher::calculate() const {
+    Result result;
+
     try {
-        if (firstTime || (recalculates && !frozen)) {
-            if (hasType<Block>(watch)) {
-                //
-                // !!! Review apply logic, right now blocks "don't have
-                // evaluator behavior" so you have to DO them.  Should
-                // that be something that watch() or watch.apply() can do?
-                //
-                value = runtime("do", watch);
-            } else
-                value = watch.apply();
-        }
-        error = nullopt;
+        if (hasType<Block>(watch)) {
+            //
+            // !!! Review apply logic, right now blocks "don't have
+            // evaluator behavior" so you have to DO them.  Should
+            // that be something that watch() or watch.apply() can do?
+            //
+            result.value = runtime("do", watch);
+        } else
+            result.value = watch.apply();
     }
     catch (evaluation_error const & e) {
-        value = nullopt;
-        error = e.error();
+        result.value = nullopt;
+        result.error = e.error();
     }
     catch (std::exception const & e) {
         std::string message {"C++ exception: "};
         message += e.what();
-        error = Error (message.c_str());
+        result.error = Error (message.c_str());
     }
     catch (...) {
         assert(false);
-        error = Error ("C++ non-std::exception");
+        result.error = Error ("C++ non-std::exception");
     }
+
+    result.reads = Footprint::of(watch);
+
+    // Mold here, as this runs on the thread that may use the runtime.  Only
+    // as much as fits in a cell is molded, so a watch on a huge block is
+    // not slow to update.
+
+    if (result.error != nullopt)
+        result.valueString = to_QString(*result.error);
+    else if (result.value == nullopt)
+        result.valueString = "no value";
+    else {
+        MoldLimits limits;
+        limits.maxBytes = 256;
+        limits.maxDepth = 4;
+        limits.all = true;
+
+        std::string molded = mold(*result.value, limits).text;
+        result.valueString = QString::fromUtf8(
+            molded.data(), static_cast<int>(molded.size())
+        );
+    }
+
+    return result;
+}
+
+
+void WatchList::Watcher::store(Result const & result) {
+    value = result.value;
+    error = result.error;
+    valueString = result.valueString;
+    reads = result.reads;
 }
 
 
 QString WatchList::Watcher::getWatchString() const {
-    if (label) {
-        Tag tag = static_cast<Tag>(*label);
-        return tag.spellingOf<QString>();
-    }
+    if (!labelString.isEmpty())
+        return labelString;
 
     // Should there be a way to automatically debug based on the
     // address values of the cell?  That could be helpful.  Could
     // also just have a mode that shows that anyway...tooltip?
 
-    return to_QString(watch);
+    return watchString;
 }
 
 
 QString WatchList::Watcher::getValueString() const {
-    if (error != nullopt)
-        return to_QString(*error);
-    if (value == nullopt)
-        return "no value";
-    return to_QString(*runtime("mold/all quote", value));
+    return valueString;
 }
 
 
@@ -247,6 +408,12 @@ WatchList::WatchList(QWidget * parent) :
         this, &WatchList::onItemChanged,
         Qt::AutoConnection
     );
+
+    connect(
+        this, &WatchList::relabeled,
+        this, &WatchList::refreshRow,
+        Qt::QueuedConnection
+    );
 }
 
 
@@ -256,29 +423,39 @@ void WatchList::pushWatcher(Watcher * watcherUnique) {
     // client can not listen to the pushWatcherRequest signal.  Should this
     // be a shared pointer?
     //
-    watchers.push_back(std::unique_ptr<Watcher>(watcherUnique));
+    {
+        QMutexLocker lock {&watchersMutex};
+        watchers.push_back(std::shared_ptr<Watcher>(watcherUnique));
+    }
 
     int count = rowCount();
     insertRow(count);
 
-    // We do not `updateWatcher(count + 1)` here, rather we wait for the
-    // event loop...
+    // The watcher was calculated when it was made, so this only paints it
     //
+    refreshRow(count + 1);
+
     emit showDockRequested(this);
 }
 
 
 void WatchList::removeWatcher(int index) {
-    watchers.erase(std::begin(watchers) + (index - 1));
+    {
+        QMutexLocker lock {&watchersMutex};
+        watchers.erase(std::begin(watchers) + (index - 1));
+    }
     removeRow(index - 1);
 }
 
 
 void WatchList::duplicateWatcher(int index) {
-    watchers.insert(
-        std::begin(watchers) + (index - 1),
-        std::unique_ptr<Watcher> {new Watcher {*watchers[index - 1]}}
-    );
+    {
+        QMutexLocker lock {&watchersMutex};
+        watchers.insert(
+            std::begin(watchers) + (index - 1),
+            std::make_shared<Watcher>(*watchers[index - 1])
+        );
+    }
 
     blockSignals(true);
     insertRow(index - 1);
@@ -289,13 +466,19 @@ void WatchList::duplicateWatcher(int index) {
 
 
 void WatchList::setFreezeState(int index, bool frozen) {
-    watchers[index - 1]->frozen = frozen;
+    {
+        QMutexLocker lock {&watchersMutex};
+        watchers[index - 1]->frozen = frozen;
+    }
     updateWatcher(index);
 }
 
 
 void WatchList::setRecalculatesState(int index, bool recalculates) {
-    watchers[index - 1]->recalculates = recalculates;
+    {
+        QMutexLocker lock {&watchersMutex};
+        watchers[index - 1]->recalculates = recalculates;
+    }
     updateWatcher(index);
 }
 
@@ -307,9 +490,31 @@ void WatchList::mousePressEvent(QMouseEvent * event) {
 
 
 void WatchList::updateWatcher(int index) {
-    Watcher &w = *watchers[index - 1];
+    bool evaluates;
+    {
+        QMutexLocker lock {&watchersMutex};
+        Watcher const & watcher = *watchers[index - 1];
+        evaluates = watcher.recalculates && !watcher.frozen;
+    }
+
+    // The row is repainted now for the change of state, and again when the
+    // evaluator thread gets to recalculating it (after any command that is
+    // running finishes)
 
-    w.evaluate(); // will not evaluate if frozen
+    refreshRow(index);
+
+    if (evaluates)
+        emit recalculationRequested(index);
+}
+
+
+void WatchList::refreshRow(int index) {
+    QMutexLocker lock {&watchersMutex};
+
+    if (index < 1 || static_cast<size_t>(index) > watchers.size())
+        return; // removed since the repaint was requested
+
+    Watcher & w = *watchers[index - 1];
 
     // We only insert a row at the table call sites (duplicate, add); this
     // won't have a table widget item by default.  Hence the if null check.
@@ -388,12 +593,94 @@ void WatchList::updateAllWatchers() {
 
     setSelectionMode(QAbstractItemView::MultiSelection);
 
+    // Values were calculated on the evaluator thread by recalculate(), so
+    // this just shows them.
+
     for (int row = 0; row < rowCount(); row++) {
-        updateWatcher(row + 1);
+        refreshRow(row + 1);
     }
 }
 
 
+void WatchList::recalculate(AnyValue const & command) {
+    Footprint writes = Footprint::of(command);
+
+    std::vector<std::shared_ptr<Watcher>> snapshot;
+    {
+        QMutexLocker lock {&watchersMutex};
+        snapshot = watchers;
+    }
+
+    bool changed = false;
+
+    for (auto & watcher : snapshot) {
+        {
+            QMutexLocker lock {&watchersMutex};
+            if (!watcher->recalculates || watcher->frozen)
+                continue;
+
+            if (!writes.mayAffect(watcher->reads))
+                continue;
+        }
+
+        Watcher::Result result = watcher->calculate();
+
+        QMutexLocker lock {&watchersMutex};
+        watcher->store(result);
+        changed = true;
+    }
+
+    // Queued to the GUI thread, where the table is repainted
+
+    if (changed)
+        emit recalculated();
+}
+
+
+void WatchList::recalculateWatcher(int index) {
+    std::shared_ptr<Watcher> watcher;
+    {
+        QMutexLocker lock {&watchersMutex};
+
+        if (index < 1 || static_cast<size_t>(index) > watchers.size())
+            return; // removed since the recalculation was requested
+
+        watcher = watchers[index - 1];
+        if (!watcher->recalculates || watcher->frozen)
+            return;
+    }
+
+    Watcher::Result result = watcher->calculate();
+
+    {
+        QMutexLocker lock {&watchersMutex};
+        watcher->store(result);
+    }
+
+    emit recalculated();
+}
+
+
+void WatchList::relabelWatcher(int index, QString const & contents) {
+    optional<Tag> label;
+    if (!contents.isEmpty())
+        label = Tag {contents};
+
+    {
+        QMutexLocker lock {&watchersMutex};
+
+        if (index < 1 || static_cast<size_t>(index) > watchers.size())
+            return; // removed since the relabeling was requested
+
+        Watcher & w = *watchers[index - 1];
+        w.label = label;
+        w.labelString = contents;
+    }
+
+    emit relabeled(index);
+}
+
+
 optional<AnyValue> WatchList::watchDialect(
     AnyValue const & arg,
     optional<Tag> const & label
@@ -471,8 +758,10 @@ optional<AnyValue> WatchList::watchDialect(
         if (index > this->watchers.size())
             throw Error ("No such watchlist item index");
 
+        QMutexLocker lock {&watchersMutex};
         optional<AnyValue> watchValue = watchers[index - 1]->value;
         optional<Error> watchError = watchers[index - 1]->error;
+        lock.unlock();
         if (removal) {
             emit removeWatcherRequested(index);
             return watchValue;
@@ -485,6 +774,7 @@ optional<AnyValue> WatchList::watchDialect(
     }
 
     if (hasType<Tag>(arg)) {
+        QMutexLocker lock {&watchersMutex};
         for (auto & watcherPtr : watchers) {
             Watcher & w = *watcherPtr;
             if (
@@ -27,6 +27,8 @@
 
 #include "optional/optional.hpp"
 
+#include <QMutex>
+#include <QSet>
 #include <QTableWidget>
 
 #include "rencpp/ren.hpp"
@@ -38,6 +40,24 @@ class WatchList : public QTableWidget
     Q_OBJECT
 
 public:
+    //
+    // What a piece of code can be seen to touch, without running it: the
+    // words it mentions, and whether any of them hold a series or object
+    // (which another word might alias).  It's "opaque" if it calls code that
+    // could read or write variables it doesn't mention.
+    //
+    struct Footprint {
+        QSet<QString> words; // lowercased, as words are case-insensitive
+        bool touchesSeries;
+        bool opaque;
+
+        Footprint () : touchesSeries (false), opaque (false) {}
+
+        static Footprint of(ren::AnyValue const & code);
+
+        bool mayAffect(Footprint const & reads) const;
+    };
+
     class Watcher {
         friend class WatchList;
 
@@ -48,6 +68,16 @@ public:
         ren::optional<ren::Tag> label;
         bool frozen;
 
+        Footprint reads;
+
+        // Molded when the value is calculated (on whichever thread did the
+        // calculating) so the GUI can repaint without calling the runtime.
+        // The name column's text is formed ahead of time in the same way.
+        //
+        QString valueString;
+        QString watchString;
+        QString labelString; // empty if there is no label
+
     public:
         // Construct will also evaluate to capture at the time of the watch
         // being added (particularly important if it's a cell)
@@ -60,12 +90,36 @@ public:
         // Evaluates and returns error if there was one, or none
         void evaluate(bool firstTime = false);
 
+        // The parts of evaluate() that run the watch (which only reads the
+        // unchanging `watch` member, so needs no lock) and that write the
+        // outcome to the watcher.
+        //
+        struct Result {
+            ren::optional<ren::AnyValue> value;
+            ren::optional<ren::Error> error;
+            QString valueString;
+
+            // Taken again each time, as what the words hold may be different
+            // (e.g. a word that held an integer now holding a series)
+            //
+            Footprint reads;
+        };
+
+        Result calculate() const;
+
+        void store(Result const & result);
+
         QString getWatchString() const;
 
         QString getValueString() const;
     };
 
-    std::vector<std::unique_ptr<Watcher>> watchers;
+    // The GUI thread adds and removes watchers while the evaluator thread
+    // recalculates them.  Recalculation holds its own references, so it can
+    // work without the lock held while the list is being changed.
+    //
+    std::vector<std::shared_ptr<Watcher>> watchers;
+    mutable QMutex watchersMutex;
 
 public:
     WatchList (QWidget * parent = nullptr);
@@ -94,11 +148,37 @@ signals:
 
     void reportStatus(QString message);
 
+    void recalculated();
+
+    // Connected (queued) to run recalculateWatcher() on the evaluator thread
+    //
+    void recalculationRequested(int index);
+
+    // Connected (queued) to run relabelWatcher() on the evaluator thread,
+    // which emits relabeled() for the row to be repainted
+    //
+    void relabelRequested(int index, QString contents);
+
+    void relabeled(int index);
+
 public slots:
     void updateWatcher(int index);
 
     void updateAllWatchers();
 
+    // Called on the evaluator thread after each command
+    //
+    void recalculate(ren::AnyValue const & command);
+
+    // Called on the evaluator thread when a watch is unfrozen or set to
+    // recalculate
+    //
+    void recalculateWatcher(int index);
+
+    // Called on the evaluator thread when a label is edited in the table
+    //
+    void relabelWatcher(int index, QString const & contents);
+
 private slots:
     void pushWatcher(Watcher * watcherUnique);
 
@@ -112,10 +192,13 @@ private slots:
 
     void onItemChanged(QTableWidgetItem * item);
 
+private:
+    void refreshRow(int index);
+
 protected:
     void mousePressEvent(QMouseEvent * event) override;
 
-    QSize sizeHint() const override; // see comment on implementation
+    QSize sizeHint() const override; // see comment on implementation
 
 public:
     // aaaand... magic! :-)
@@ -27,8 +27,16 @@ namespace ren {
 class AnyArray : public AnySeries {
 protected:
     friend class AnyValue;
-    AnyArray (Dont) noexcept : AnySeries (Dont::Initialize) {}
-    static bool isValid(REBVAL const * cell);
+    AnyArray (Dont dont) noexcept : AnySeries (dont) {}
+    static bool isValid(REBVAL const * cell) {
+        Kind kind = internal::cellKind(cell);
+        return kind == Kind::Block
+            || kind == Kind::Group
+            || kind == Kind::Path
+            || kind == Kind::SetPath
+            || kind == Kind::GetPath
+            || kind == Kind::LitPath;
+    }
 
     // Friending doesn't seem to be enough for gcc 4.6, see SO writeup:
     //    http://stackoverflow.com/questions/32983193/
@@ -114,7 +122,7 @@ template <class C, CellFunction F, typename BracesT=void>
 class AnyArray_ : public AnyArray {
 protected:
     friend class AnyValue;
-    AnyArray_ (Dont) : AnyArray (Dont::Initialize) {}
+    AnyArray_ (Dont dont) : AnyArray (dont) {}
 
 public:
     AnyArray_ (
@@ -167,6 +175,10 @@ public:
     {
     }
 
+    // Lets a BlockLoadable make a nested brace list into this type
+    //
+    static constexpr CellFunction cellFunction() { return F; }
+
     // A block can be invoked something like a function via DO, so it makes
     // sense for it to have a way of applying it...but it doesn't take
     // any "parameters"
@@ -199,7 +211,9 @@ class Block
     using AnyArray::initBlock;
 
 protected:
-    static bool isValid(REBVAL const * cell);
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::Block;
+    }
 
 public:
     friend class AnyValue;
@@ -211,7 +225,9 @@ class Group
     : public internal::AnyArray_<Group, &AnyArray::initGroup>
 {
 protected:
-    static bool isValid(REBVAL const * cell);
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::Group;
+    }
 
 public:
     friend class AnyValue;
@@ -224,7 +240,9 @@ class Path
 {
 protected:
     static void initCell(REBVAL *cell);
-    static bool isValid(REBVAL const * cell);
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::Path;
+    }
 
 public:
     friend class AnyValue;
@@ -243,7 +261,9 @@ class SetPath
 {
 protected:
     static void initCell(REBVAL *cell);
-    static bool isValid(REBVAL const * cell);
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::SetPath;
+    }
 
 public:
     friend class AnyValue;
@@ -264,7 +284,9 @@ class GetPath
 {
 protected:
     static void initCell(REBVAL *cell);
-    static bool isValid(REBVAL const * cell);
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::GetPath;
+    }
 
 public:
     friend class AnyValue;
@@ -287,7 +309,9 @@ class LitPath
 {
 protected:
     static void initCell(REBVAL *cell);
-    static bool isValid(REBVAL const * cell);
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::LitPath;
+    }
 
 public:
     friend class AnyValue;
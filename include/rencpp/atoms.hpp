@@ -19,7 +19,11 @@
 // See http://rencpp.hostilefork.com for more information on this project
 //
 
+#include <chrono>
+#include <vector>
+
 #include "value.hpp"
+#include "arrays.hpp"
 
 //
 // These classes inherit from AnyValue, without inheriting its constructors.
@@ -31,7 +35,7 @@
 //
 // protected:
 //    friend class AnyValue;
-//    Foo (Dont) : AnyValue (Dont::Initialize) {}
+//    Foo (Dont dont) : AnyValue (dont) {}
 //    inline bool isValid() const { return ...; }
 //
 // These are needed by the base class casting operator in AnyValue, which has
@@ -48,8 +52,19 @@ namespace ren {
 class Atom : public AnyValue {
 protected:
     friend class AnyValue;
-    Atom (Dont) noexcept : AnyValue (Dont::Initialize) {}
-    static bool isValid(REBVAL const * cell);
+    Atom (Dont dont) noexcept : AnyValue (dont) {}
+    static bool isValid(REBVAL const * cell) {
+        // !!! Review handling of void.  It is not considered an atom, correct?
+        //
+        Kind kind = internal::cellKind(cell);
+        return kind == Kind::Blank
+            || kind == Kind::Logic
+            || kind == Kind::Char
+            || kind == Kind::Integer
+            || kind == Kind::Decimal
+            || kind == Kind::Time
+            || kind == Kind::Date;
+    }
 
 public:
     // We need to inherit AnyValue's constructors, as an Atom can be
@@ -89,8 +104,10 @@ constexpr AnyValue::blank_t blank {AnyValue::blank_t::init{}};
 class Blank : public Atom {
 protected:
     friend class AnyValue;
-    Blank (Dont) noexcept : Atom (Dont::Initialize) {}
-    static bool isValid(REBVAL const * cell);
+    Blank (Dont dont) noexcept : Atom (dont) {}
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::Blank;
+    }
 
 public:
     explicit Blank (Engine * engine = nullptr) : Atom (blank, engine) {}
@@ -105,8 +122,10 @@ public:
 class Logic : public Atom {
 protected:
     friend class AnyValue;
-    Logic (Dont) noexcept : Atom (Dont::Initialize) {}
-    static bool isValid(REBVAL const * cell);
+    Logic (Dont dont) noexcept : Atom (dont) {}
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::Logic;
+    }
 
 public:
     // Trick so that Logic can be implicitly constructed from bool but not
@@ -143,7 +162,9 @@ public:
     {
     }
 
-    operator bool () const;
+    operator bool () const {
+        return !internal::cellIsFalsey(cell);
+    }
 };
 
 
@@ -156,8 +177,10 @@ class Character : public Atom {
 protected:
     friend class AnyValue;
     friend class AnyString;
-    Character (Dont) noexcept : Atom (Dont::Initialize) {}
-    static bool isValid(REBVAL const * cell);
+    Character (Dont dont) noexcept : Atom (dont) {}
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::Char;
+    }
 
 public:
     Character (char c, Engine * engine = nullptr) :
@@ -206,8 +229,10 @@ public:
 class Integer : public Atom {
 protected:
     friend class AnyValue;
-    Integer (Dont) noexcept : Atom (Dont::Initialize) {}
-    static bool isValid(REBVAL const * cell);
+    Integer (Dont dont) noexcept : Atom (dont) {}
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::Integer;
+    }
 
 public:
     Integer (int i, Engine * engine = nullptr) :
@@ -215,7 +240,10 @@ public:
     {
     }
 
-    operator int () const;
+    // !!! How to correctly support 64-bit coercions?  Throw if out of range?
+    operator int () const {
+        return static_cast<int>(internal::cellInteger(cell));
+    }
 };
 
 
@@ -227,8 +255,10 @@ public:
 class Float : public Atom {
 protected:
     friend class AnyValue;
-    Float (Dont) noexcept : Atom (Dont::Initialize) {}
-    static bool isValid(REBVAL const * cell);
+    Float (Dont dont) noexcept : Atom (dont) {}
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::Decimal;
+    }
 
 public:
     Float (double d, Engine * engine = nullptr) :
@@ -236,7 +266,39 @@ public:
     {
     }
 
-    operator double () const;
+    operator double () const {
+        return internal::cellDecimal(cell);
+    }
+};
+
+
+
+//
+// TIME
+//
+
+//
+// A TIME! is a signed count of nanoseconds, which may be more than a day
+// (e.g. `36:00`), so it converts to and from a std::chrono duration.
+//
+
+class Time : public Atom {
+protected:
+    friend class AnyValue;
+    Time (Dont dont) noexcept : Atom (dont) {}
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::Time;
+    }
+
+public:
+    // Coarser durations (seconds, minutes...) convert to this implicitly
+    //
+    explicit Time (
+        std::chrono::nanoseconds duration,
+        Engine * engine = nullptr
+    );
+
+    std::chrono::nanoseconds duration() const;
 };
 
 
@@ -258,18 +320,60 @@ public:
 // information from the date you can do that with calls into the
 // evaluator.
 //
+// What *can* be done without going through text is converting to and from
+// a std::chrono::system_clock::time_point, for timestamps:
+//
+//     Date stamp {std::chrono::system_clock::now(), std::chrono::hours {2}};
+//     // e.g. 18-Oct-2026/14:05:09.123456789+2:00
+//
+//     auto when = stamp.timePoint(); // the same instant, in UTC
+//
+// A DATE! with no time is taken as midnight, and one with no zone as UTC.
+// Zones are whole quarter hours between -15:00 and +15:00.
+//
+// For a block of timestamps, the bulk conversions read or write the array
+// directly instead of making a Date for each item.
+//
 
 class Date : public Atom {
 protected:
     friend class AnyValue;
-    Date (Dont) noexcept : Atom (Dont::Initialize) {}
-    static bool isValid(REBVAL const * cell);
+    Date (Dont dont) noexcept : Atom (dont) {}
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::Date;
+    }
 
 public:
+    using time_point = std::chrono::system_clock::time_point;
+
     explicit Date (
         std::string const & str,
         Engine * engine = nullptr
     );
+
+    explicit Date (
+        time_point when,
+        std::chrono::minutes zone = std::chrono::minutes {0},
+        Engine * engine = nullptr
+    );
+
+    time_point timePoint() const;
+
+    bool hasTime() const;
+    bool hasZone() const;
+    std::chrono::minutes zone() const;
+
+public:
+    // Every item from the block's position must be a DATE!, or this throws
+    // bad_value_cast
+    //
+    static std::vector<time_point> timePoints(AnyArray const & dates);
+
+    static Block blockOf(
+        std::vector<time_point> const & times,
+        std::chrono::minutes zone = std::chrono::minutes {0},
+        Engine * engine = nullptr
+    );
 };
 
 
@@ -0,0 +1,205 @@
+#ifndef RENCPP_CELL_HPP
+#define RENCPP_CELL_HPP
+
+//
+// cell.hpp
+// This file is part of RenCpp
+// Copyright (C) 2015-2018 HostileFork.com
+//
+// Licensed under the Boost License, Version 1.0 (the "License")
+//
+//      http://www.boost.org/LICENSE_1_0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.  See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// See http://rencpp.hostilefork.com for more information on this project
+//
+//=////////////////////////////////////////////////////////////////////////=//
+//
+// The cells behind a ren::AnyValue are opaque to clients of the binding (see
+// notes in hooks.h on why %sys-core.h can't be included in C++ code at
+// large).  The price of that opacity was that every `hasType<Integer>()` or
+// `static_cast<int>(someInteger)` was a call into a separate translation
+// unit, which the optimizer can't see through in a tight loop.
+//
+// This file publishes just enough of the cell layout to answer the most
+// common questions inline: what kind of value is in a cell, whether it is
+// "truthy", and the immediate payloads of INTEGER! and DECIMAL!.  Everything
+// else still goes through the runtime.
+//
+// The layout described here is a *contract* with the runtime it is built
+// against, and %src/cell.cpp checks every constant against the real
+// definitions with static_assert().  If you update the runtime and those
+// assertions fail, fix the constants and bump RENCPP_CELL_ABI_VERSION so
+// code compiled against the old header can detect the mismatch.
+//
+
+#include <cstdint>
+#include <cstring> // memcpy for alias-safe payload reads
+
+#include "hooks.h"
+
+
+#define RENCPP_CELL_ABI_VERSION 1
+
+
+namespace ren {
+
+//
+// KIND
+//
+
+//
+// Mirrors `enum Reb_Kind`.  Kind::Void is REB_MAX_VOID, which a ren::AnyValue
+// never holds (that's the disengaged state of an optional<AnyValue>).
+//
+
+enum class Kind : unsigned char {
+    Trash = 0,
+    Function,
+    Bar,
+    LitBar,
+    Word,
+    SetWord,
+    GetWord,
+    LitWord,
+    Refinement,
+    Issue,
+    Path,
+    SetPath,
+    GetPath,
+    LitPath,
+    Group,
+    Block,
+    Binary,
+    String,
+    File,
+    Email,
+    Url,
+    Tag,
+    Bitset,
+    Image,
+    Vector,
+    Map,
+    Varargs,
+    Object,
+    Frame,
+    Module,
+    Error,
+    Port,
+    Logic,
+    Integer,
+    Decimal,
+    Percent,
+    Money,
+    Char,
+    Pair,
+    Tuple,
+    Time,
+    Date,
+    Datatype,
+    Typeset,
+    Gob,
+    Event,
+    Handle,
+    Struct,
+    Library,
+    Blank,
+    Void, // REB_MAX_VOID
+
+    Max
+};
+
+
+namespace internal {
+
+//
+// CELL LAYOUT
+//
+
+//
+// A cell is four platform pointers: a header of flag bits, an "extra" slot,
+// and a two-pointer payload.  The kind lives in the low byte of the header,
+// and FALSEY is a single header bit (set on BLANK! and LOGIC! false).
+//
+
+struct CellLayout {
+    static constexpr size_t size = 4 * sizeof(void *);
+
+    static constexpr size_t headerOffset = 0;
+    static constexpr size_t payloadOffset = 2 * sizeof(void *);
+
+    static constexpr uintptr_t kindMask = 0xFF;
+
+    // VALUE_FLAG_FALSEY is FLAGIT_LEFT(GENERAL_VALUE_BIT + 1)
+    //
+    static constexpr uintptr_t falseyFlag =
+        static_cast<uintptr_t>(1) << (sizeof(uintptr_t) * 8 - 1 - 9);
+};
+
+
+// Step through contiguous cells, e.g. the items of an array or the variables
+// of a context, without needing the definition of REBVAL.
+//
+inline REBVAL * cellAt(REBVAL * base, size_t index) {
+    return reinterpret_cast<REBVAL *>(
+        reinterpret_cast<unsigned char *>(base) + index * CellLayout::size
+    );
+}
+
+inline uintptr_t cellHeader(REBVAL const * cell) {
+    uintptr_t bits;
+    memcpy(
+        &bits,
+        reinterpret_cast<unsigned char const *>(cell)
+            + CellLayout::headerOffset,
+        sizeof(bits)
+    );
+    return bits;
+}
+
+inline Kind cellKind(REBVAL const * cell) {
+    return static_cast<Kind>(cellHeader(cell) & CellLayout::kindMask);
+}
+
+inline bool cellIsFalsey(REBVAL const * cell) {
+    return (cellHeader(cell) & CellLayout::falseyFlag) != 0;
+}
+
+template <typename T>
+inline T cellPayload(REBVAL const * cell) {
+    T result;
+    memcpy(
+        &result,
+        reinterpret_cast<unsigned char const *>(cell)
+            + CellLayout::payloadOffset,
+        sizeof(result)
+    );
+    return result;
+}
+
+inline int64_t cellInteger(REBVAL const * cell) {
+    return cellPayload<int64_t>(cell);
+}
+
+inline double cellDecimal(REBVAL const * cell) {
+    return cellPayload<double>(cell);
+}
+
+
+#if !defined(NDEBUG)
+    // Compares this header's idea of a cell against the runtime's, on values
+    // made by the runtime; called once during startup.
+    //
+    void checkCellLayout();
+#endif
+
+} // end namespace internal
+
+} // end namespace ren
+
+#endif
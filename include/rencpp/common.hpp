@@ -247,8 +247,11 @@ struct make_indices<0, Ind...>:
 // This is a clone of the proposed std::type_at
 //
 
+template <unsigned N, typename... Ts>
+struct type_at; // (no type when N is out of range, e.g. no arguments)
+
 template <unsigned N, typename T, typename... R>
-struct type_at
+struct type_at<N, T, R...>
 {
     using type = typename type_at<N-1, R...>::type;
 };
@@ -50,8 +50,10 @@ class Engine;
 class AnyContext : public AnyValue {
 protected:
     friend class AnyValue;
-    AnyContext (Dont) noexcept : AnyValue (Dont::Initialize) {}
-    static bool isValid(REBVAL const * cell);
+    AnyContext (Dont dont) noexcept : AnyValue (dont) {}
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::Object;
+    }
 
     // Friending doesn't seem to be enough for gcc 4.6, see SO writeup:
     //    http://stackoverflow.com/questions/32983193/
@@ -156,7 +158,7 @@ template <class C, CellFunction F>
 class AnyContext_ : public AnyContext {
 protected:
     friend class AnyValue;
-    AnyContext_ (Dont) : AnyContext (Dont::Initialize) {}
+    AnyContext_ (Dont dont) : AnyContext (dont) {}
 
 public:
     AnyContext_ (
@@ -231,7 +233,9 @@ class Object
     using AnyContext::initObject;
 
 protected:
-    static bool isValid(REBVAL const * cell);
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::Object;
+    }
 
 public:
     friend class AnyValue;
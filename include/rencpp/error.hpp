@@ -20,6 +20,9 @@
 //
 
 #include <exception>
+#include <initializer_list>
+#include <string>
+#include <utility>
 
 #include "value.hpp"
 #include "context.hpp"
@@ -79,6 +82,14 @@ namespace ren {
 // That is "universal", and can be processed both by ren::Function as well as
 // in the typical C++ execution stack.
 //
+// An error can also be given an id other than `message`, and extra fields
+// for handlers to inspect, with the () form:
+//
+//     throw ren::Error ("out-of-range", "Value too large", {{"limit", 255}});
+//
+// These are built directly and not LOADed, so the message may contain any
+// characters (including braces) and costs no more than copying it.
+//
 
 class Error
     : public internal::AnyContext_<Error, &AnyContext::initError>
@@ -86,14 +97,25 @@ class Error
     using AnyContext::initError;
 
 protected:
-    static bool isValid(REBVAL const * cell);
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::Error;
+    }
 
 public:
     friend class AnyValue;
     using internal::AnyContext_<Error, &AnyContext::initError>::AnyContext_;
 
 public:
+    using Field = std::pair<char const *, AnyValue>;
+
     Error (const char * msg, Engine * engine = nullptr);
+
+    Error (
+        const char * id,
+        std::string const & msg,
+        std::initializer_list<Field> fields = {},
+        Engine * engine = nullptr
+    );
 };
 
 
@@ -104,20 +126,45 @@ public:
 //
 // Unlike evaluation_error, these can happen even if there's no runtime.
 
+namespace internal {
+
+// The description of an error is only made if asked for, because a catcher
+// that handles the error by its id or just retries shouldn't pay to mold it.
+//
+inline char const * describeError(
+    std::string & whatString,
+    Error const & error,
+    char const * fallback
+) noexcept {
+    if (whatString.empty()) {
+        try {
+            whatString = to_string(error);
+        }
+        catch (...) {
+            whatString = fallback;
+        }
+    }
+    return whatString.c_str();
+}
+
+} // end namespace internal
+
+
 class load_error : public std::exception {
 private:
     Error errorValue;
-    std::string whatString;
+    mutable std::string whatString;
 
 public:
     load_error (Error const & error) :
-        errorValue (error),
-        whatString (to_string(errorValue))
+        errorValue (error)
     {
     }
 
     char const * what() const noexcept override {
-        return whatString.c_str();
+        return internal::describeError(
+            whatString, errorValue, "ren::load_error"
+        );
     }
 
     Error error() const noexcept {
@@ -129,17 +176,18 @@ public:
 class evaluation_error : public std::exception {
 private:
     Error errorValue;
-    std::string whatString;
+    mutable std::string whatString;
 
 public:
     evaluation_error (Error const & error) :
-        errorValue (error),
-        whatString (to_string(errorValue))
+        errorValue (error)
     {
     }
 
     char const * what() const noexcept override {
-        return whatString.c_str();
+        return internal::describeError(
+            whatString, errorValue, "ren::evaluation_error"
+        );
     }
 
     Error error() const noexcept {
@@ -181,6 +229,44 @@ public:
 };
 
 
+
+//
+// NON-THROWING EVALUATION
+//
+
+//
+// A C++ exception costs far more to unwind than a Ren THROW does.  Code that
+// uses THROW (or errors) for ordinary control flow can ask for the outcome
+// of an evaluation as a value instead, and nothing is thrown:
+//
+//     auto outcome = runtime.tryEvaluate({"find-first", items});
+//     if (outcome.status == Evaluation::Status::Thrown) ...
+//
+// (This includes errors in loading the code, which would otherwise have been
+// a load_error, and halts from runtime.cancel().)
+//
+
+struct Evaluation {
+    enum class Status {
+        Completed,
+        Thrown,
+        Errored,
+        Halted
+    };
+
+    Status status = Status::Completed;
+
+    // The result if Completed, or the value thrown if Thrown (either may be
+    // absent, as with evaluations that give back no value)
+    //
+    optional<AnyValue> value;
+
+    optional<AnyValue> name; // the name if Thrown by THROW/NAME
+
+    optional<Error> error; // set if Errored
+};
+
+
 }
 
 #endif
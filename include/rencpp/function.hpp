@@ -92,6 +92,8 @@
 
 namespace ren {
 
+class Profiler;
+
 namespace internal {
 
 //
@@ -156,8 +158,10 @@ using RenCppfunFreer = void (*)(void *cppfun);
 class Function : public AnyValue {
 protected:
     friend class AnyValue;
-    Function (Dont) : AnyValue (Dont::Initialize) {}
-    static bool isValid(REBVAL const * cell);
+    Function (Dont dont) : AnyValue (dont) {}
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::Function;
+    }
 
 private:
     //
@@ -168,6 +172,11 @@ private:
     //
     static int32_t Ren_Cpp_Dispatcher(struct Reb_Frame *f);
 
+    // The sampling profiler recognizes C++-implemented functions on the
+    // frame stack by their dispatcher.
+    //
+    friend class Profiler;
+
     // Most classes can get away with setting up cell bits all in the
     // implementation files, but FunctionGenerator is a template.  It
     // needs to be able to finalize "in view".  We might consider another
@@ -0,0 +1,140 @@
+#ifndef RENCPP_GENERATOR_HPP
+#define RENCPP_GENERATOR_HPP
+
+//
+// generator.hpp
+// This file is part of RenCpp
+// Copyright (C) 2015-2018 HostileFork.com
+//
+// Licensed under the Boost License, Version 1.0 (the "License")
+//
+//      http://www.boost.org/LICENSE_1_0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.  See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// See http://rencpp.hostilefork.com for more information on this project
+//
+//=////////////////////////////////////////////////////////////////////////=//
+//
+// For a script to hand a result to C++ it has to return it, so producing a
+// lot of results means collecting them all into one block first.
+//
+// A ren::Generator runs a script that gives its results to C++ as it goes,
+// by calling YIELD.  The C++ side pulls them out with a range-based for:
+//
+//     Generator records {
+//         Block {"for-each row rows [yield make-record row]"}
+//     };
+//
+//     for (AnyValue record : records)
+//         writeRecord(output, record);
+//
+// The script doesn't start until the first value is asked for, and it is
+// paused inside YIELD whenever C++ has not asked for more yet.  So no more
+// than `batchSize` values are waiting at any time.  Handing values over in
+// batches rather than one at a time is much cheaper; a batch is also handed
+// over when the script ends.
+//
+// `yield` is bound in the body only (it is a parameter of the function the
+// body is made into), and returns no value.  If the script fails, next()
+// rethrows the error (as with runtime(...)) once the values yielded before
+// the failure are taken.
+//
+// Stopping early (e.g. `break` out of the loop) is fine.  When the Generator
+// is destroyed, a script still paused in YIELD is halted.
+//
+// !!! The script is run on a thread of its own, because the evaluator can't
+// be paused in the middle of a script and later resumed on the same stack.
+// Only one of the two threads runs at a time, so no locking is needed in the
+// runtime.  But the evaluator's stack of frames is shared, so while a
+// script is paused, C++ may do other evaluations (and iterate other
+// generators) only if they finish before it is resumed.  In particular, a
+// Generator made inside a ren::Function must be done with before that
+// function returns.  Resuming out of order throws std::logic_error.
+// Destroying a paused Generator out of order can't halt its script, so the
+// script and its thread are leaked (with a message on stderr) instead.
+//
+// !!! Requires POSIX threads.  On Windows the constructor will throw.
+//
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+
+#include "value.hpp"
+#include "arrays.hpp"
+#include "function.hpp"
+
+
+namespace ren {
+
+class Generator {
+public:
+    explicit Generator (Block const & body, size_t batchSize = 256);
+
+    Generator (Generator const & other) = delete;
+    Generator & operator= (Generator const & other) = delete;
+
+    ~Generator ();
+
+    // The next value yielded, or nullopt once the script has finished
+    //
+    optional<AnyValue> next();
+
+public:
+    class iterator {
+        friend class Generator;
+
+        Generator * generator; // nullptr for end()
+        optional<AnyValue> current;
+
+        explicit iterator (Generator * generator) :
+            generator (generator)
+        {
+            if (generator)
+                ++(*this);
+        }
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = AnyValue;
+        using difference_type = std::ptrdiff_t;
+        using pointer = AnyValue const *;
+        using reference = AnyValue const &;
+
+        AnyValue const & operator*() const { return *current; }
+
+        AnyValue const * operator->() const { return &*current; }
+
+        iterator & operator++() {
+            current = generator->next();
+            if (!current)
+                generator = nullptr;
+            return *this;
+        }
+
+        bool operator==(iterator const & other) const {
+            return generator == other.generator;
+        }
+
+        bool operator!=(iterator const & other) const {
+            return generator != other.generator;
+        }
+    };
+
+    iterator begin() { return iterator {this}; }
+
+    iterator end() { return iterator {nullptr}; }
+
+private:
+    struct State;
+    std::unique_ptr<State> state;
+};
+
+} // end namespace ren
+
+#endif
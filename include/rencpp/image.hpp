@@ -19,21 +19,123 @@
 // See http://rencpp.hostilefork.com for more information on this project
 //
 
+#include <cstddef>
+#include <type_traits>
+
 #include "value.hpp"
 
 
 namespace ren {
 
 
+//
+// PIXEL SPANS
+//
+
+//
+// A description of 32-bit pixels in someone else's memory, e.g. a decoder's
+// output buffer or a texture being uploaded.  `stride` is the distance in
+// bytes from the start of one row to the next, which may be larger than
+// `width * 4` if rows are padded.
+//
+// ChannelOrder gives the order of the bytes *in memory*, so RGBA means the
+// red byte comes first.  (This is how OpenGL names formats; QImage and
+// Windows name them by how they look in a little-endian 32-bit word, so
+// what they call ARGB32 is BGRA here.)
+//
+
+enum class ChannelOrder : unsigned char {
+    RGBA,
+    BGRA,
+    ARGB
+};
+
+
+namespace internal {
+
+template <class Byte>
+struct PixelSpan_ {
+    Byte * data;
+    size_t width;
+    size_t height;
+    size_t stride;
+    ChannelOrder order;
+    bool premultiplied;
+
+    PixelSpan_ (
+        Byte * data,
+        size_t width,
+        size_t height,
+        size_t stride,
+        ChannelOrder order,
+        bool premultiplied = false
+    ) :
+        data (data),
+        width (width),
+        height (height),
+        stride (stride),
+        order (order),
+        premultiplied (premultiplied)
+    {
+    }
+
+    // A span of mutable pixels can be used where read-only ones are expected
+    //
+    template <
+        class Other,
+        typename = typename std::enable_if<
+            std::is_convertible<Other *, Byte *>::value
+        >::type
+    >
+    PixelSpan_ (PixelSpan_<Other> const & other) :
+        PixelSpan_ (
+            other.data,
+            other.width,
+            other.height,
+            other.stride,
+            other.order,
+            other.premultiplied
+        )
+    {
+    }
+
+    Byte * row(size_t y) const { return data + y * stride; }
+};
+
+} // end namespace internal
+
+
+using PixelSpan = internal::PixelSpan_<unsigned char>;
+
+using ConstPixelSpan = internal::PixelSpan_<unsigned char const>;
+
+
+//
+// Copy pixels between spans of the same dimensions, changing the channel
+// order and premultiplication as needed.  Reordering and premultiplying are
+// done with SSE2 where available.  (Un-premultiplying needs a division per
+// channel and is done a pixel at a time.)
+//
+// The spans may be the same memory, to convert in place, if they have the
+// same stride.  Otherwise they must not overlap at all, or this throws.
+//
+
+void convertPixels(ConstPixelSpan const & from, PixelSpan const & to);
+
+
+
 //
 // IMAGE
 //
 
 //
 // Rebol has a native IMAGE! type, which a few codecs have been written for
-// to save and load.  We don't do much with it in RenCpp at this point
-// unless you are building with the Qt classlib, in which case we need to
-// go back and forth with a QImage.
+// to save and load.  When building with the Qt classlib, it converts back
+// and forth with QImage.
+//
+// Independent of Qt, an image can be made from or copied out to any buffer
+// of 32-bit pixels that a PixelSpan can describe, and its pixels can be
+// accessed in place.
 //
 // It's not clear if this should be in the standard RenCpp or if it belongs
 // in some kind of extensions module.  In Rebol at least, the IMAGE! was
@@ -48,10 +150,38 @@ namespace ren {
 class Image : public AnyValue {
 protected:
     friend class AnyValue;
-    Image (Dont) noexcept : AnyValue (Dont::Initialize) {}
-    static bool isValid(REBVAL const * cell);
+    Image (Dont dont) noexcept : AnyValue (dont) {}
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::Image;
+    }
+
+    void initFromPixels(ConstPixelSpan const & pixels, Engine * engine);
 
 public:
+    // IMAGE! holds 0xAARRGGBB words with straight (not premultiplied) alpha,
+    // which on the little-endian machines we build for is BGRA in memory.
+    //
+    static constexpr ChannelOrder nativeOrder = ChannelOrder::BGRA;
+
+    // Copies the pixels into a new IMAGE!, converting as it goes
+    //
+    explicit Image (ConstPixelSpan const & pixels, Engine * engine = nullptr);
+
+    size_t width() const;
+    size_t height() const;
+
+    // Views of the IMAGE!'s own pixels, in nativeOrder.  These are only
+    // valid while the image is alive and not resized.
+    //
+    ConstPixelSpan pixels() const;
+    PixelSpan pixels();
+
+    // Copy out the pixels, in whatever format `to` describes
+    //
+    void readPixels(PixelSpan const & to) const {
+        convertPixels(pixels(), to);
+    }
+
 #if REN_CLASSLIB_QT == 1
     explicit Image (QImage const & image, Engine * engine = nullptr);
     operator QImage () const;
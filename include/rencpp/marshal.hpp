@@ -0,0 +1,523 @@
+#ifndef RENCPP_MARSHAL_HPP
+#define RENCPP_MARSHAL_HPP
+
+//
+// marshal.hpp
+// This file is part of RenCpp
+// Copyright (C) 2015-2018 HostileFork.com
+//
+// Licensed under the Boost License, Version 1.0 (the "License")
+//
+//      http://www.boost.org/LICENSE_1_0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.  See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// See http://rencpp.hostilefork.com for more information on this project
+//
+//=////////////////////////////////////////////////////////////////////////=//
+//
+// Moving a C++ record into an OBJECT! by way of the evaluator means building
+// a spec block, running MAKE OBJECT! on it, and having the words bound and
+// collected all over again for every record.  Getting it back out means a
+// path lookup per field.
+//
+// Instead, a struct can list its fields once:
+//
+//     struct Quote {
+//         std::string symbol;
+//         double bid;
+//         double ask;
+//         int volume;
+//     };
+//
+//     RENCPP_MARSHAL(Quote, symbol, bid, ask, volume)
+//
+// ...and then be converted directly:
+//
+//     Object obj = ren::toObject(quote);    // make object! [symbol: ...]
+//     Block row = ren::toBlock(quote);      // ["IBM" 10.5 10.6 1020]
+//     Quote back = ren::fromObject<Quote>(obj);
+//
+//     Block all = ren::toObjects(quotes);   // std::vector<Quote> -> block
+//     auto quotes2 = ren::fromObjects<Quote>(all);
+//
+// The field names are interned once per type (with underscores becoming
+// hyphens, so `last_trade` is LAST-TRADE).  Every object made from a given
+// type shares one keylist, so making one is a shallow copy of a prototype
+// followed by writing the fields straight into its variable slots.  Reading
+// an object looks up the slot indices by key, and caches them per keylist,
+// so reading a block of objects made by toObjects() only looks up once.
+//
+// Supported field types are bool, integral and floating point types,
+// std::string, any RenCpp value class, other RENCPP_MARSHAL'd structs, and
+// std::vector<> and optional<> of any of those.  A disengaged optional is
+// written as BLANK!, and read back from BLANK! or a missing key.  Other
+// fields are left as they are when a key is missing, and a value of the
+// wrong type throws bad_value_cast.
+//
+// RENCPP_MARSHAL must be used at global scope, and supports up to 16 fields.
+//
+// !!! Like the rest of RenCpp, this is not safe to use from more than one
+// thread at a time.
+//
+
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "value.hpp"
+#include "arrays.hpp"
+#include "context.hpp"
+#include "visit.hpp" // internal::Borrowed
+
+
+namespace ren {
+
+//
+// MARSHAL TRAITS
+//
+
+//
+// Specialized by RENCPP_MARSHAL for each struct it is used on
+//
+
+template <class T>
+struct Marshal {
+    static constexpr bool defined = false;
+};
+
+
+
+namespace internal {
+
+//
+// RECORD LAYOUT
+//
+
+//
+// Per-struct runtime state: the interned keys and a prototype object that
+// has them, as well as the slot indices of the last keylist we were asked to
+// read from.
+//
+
+class RecordLayout {
+public:
+    RecordLayout (char const * const names[], size_t count);
+
+    RecordLayout (RecordLayout const & other) = delete;
+    RecordLayout & operator= (RecordLayout const & other) = delete;
+
+private:
+    friend class Marshaller;
+
+    size_t count;
+    std::vector<void *> canons; // REBSTR*, kept alive by prototype's keys
+    AnyValue prototype; // OBJECT! with a blank for each field
+    size_t firstIndex; // the prototype's fields are contiguous from here
+
+    void const * cachedKeylist;
+    std::vector<size_t> cachedIndices; // 0 if that field is absent
+};
+
+
+
+//
+// FIELD MARSHALLING
+//
+
+class Marshaller {
+public:
+    static RenEngineHandle engineHandle(Engine * engine);
+
+
+    // Writing.  Slots are cells that the GC can already see, which are
+    // overwritten with the marshalled value.
+
+    static void putInteger(REBVAL * slot, int64_t i);
+    static void putDecimal(REBVAL * slot, double d);
+    static void putLogic(REBVAL * slot, bool b);
+    static void putString(REBVAL * slot, std::string const & utf8);
+    static void putBlank(REBVAL * slot);
+
+    // Each returns a pointer to the first of `count` contiguous cells to
+    // fill in, which are BLANK! to start with.
+    //
+    static REBVAL * putObject(REBVAL * slot, RecordLayout & layout);
+    static REBVAL * putBlock(REBVAL * slot, size_t count);
+
+    static void put(REBVAL * slot, bool b) { putLogic(slot, b); }
+
+    static void put(REBVAL * slot, std::string const & s) {
+        putString(slot, s);
+    }
+
+    static void put(REBVAL * slot, char const * s) {
+        putString(slot, s);
+    }
+
+    template <class T>
+    static typename std::enable_if<
+        std::is_integral<T>::value && !std::is_same<T, bool>::value
+    >::type put(REBVAL * slot, T i) {
+        putInteger(slot, static_cast<int64_t>(i));
+    }
+
+    template <class T>
+    static typename std::enable_if<std::is_floating_point<T>::value>::type
+    put(REBVAL * slot, T d) {
+        putDecimal(slot, static_cast<double>(d));
+    }
+
+    template <class T>
+    static typename std::enable_if<std::is_base_of<AnyValue, T>::value>::type
+    put(REBVAL * slot, T const & value) {
+        RL_Move(slot, value.cell);
+    }
+
+    template <class T>
+    static typename std::enable_if<Marshal<T>::defined>::type
+    put(REBVAL * slot, T const & record) {
+        putFields(putObject(slot, Marshal<T>::layout()), record);
+    }
+
+    template <class T>
+    static void put(REBVAL * slot, optional<T> const & opt) {
+        if (opt == nullopt)
+            putBlank(slot);
+        else
+            put(slot, *opt);
+    }
+
+    template <class T>
+    static void put(REBVAL * slot, std::vector<T> const & items) {
+        REBVAL * item = putBlock(slot, items.size());
+        for (T const & value : items) {
+            put(item, value);
+            item = cellAt(item, 1);
+        }
+    }
+
+    template <class T>
+    static void putFields(REBVAL * first, T const & record) {
+        Marshal<T>::fields(record, FieldWriter {first});
+    }
+
+
+    // Reading.  Slots may be null if the source has no such key.
+
+    [[noreturn]] static void wrongType(REBVAL const * slot, char const * want);
+
+    static std::string getString(REBVAL * slot);
+
+    // Fills in `slots` with `count` pointers, null for absent keys
+    //
+    static void objectSlots(
+        REBVAL * slots[],
+        REBVAL const * object,
+        RecordLayout & layout
+    );
+
+    static size_t arrayLength(REBVAL const * array);
+    static REBVAL * arrayHead(REBVAL const * array);
+
+    static void get(bool & b, REBVAL * slot, RenEngineHandle) {
+        if (cellKind(slot) != Kind::Logic)
+            wrongType(slot, "LOGIC!");
+        b = !cellIsFalsey(slot);
+    }
+
+    static void get(std::string & s, REBVAL * slot, RenEngineHandle) {
+        s = getString(slot);
+    }
+
+    template <class T>
+    static typename std::enable_if<
+        std::is_integral<T>::value && !std::is_same<T, bool>::value
+    >::type get(T & i, REBVAL * slot, RenEngineHandle) {
+        if (cellKind(slot) != Kind::Integer)
+            wrongType(slot, "INTEGER!");
+        i = static_cast<T>(cellInteger(slot));
+    }
+
+    template <class T>
+    static typename std::enable_if<std::is_floating_point<T>::value>::type
+    get(T & d, REBVAL * slot, RenEngineHandle) {
+        switch (cellKind(slot)) {
+        case Kind::Decimal:
+            d = static_cast<T>(cellDecimal(slot));
+            break;
+
+        case Kind::Integer:
+            d = static_cast<T>(cellInteger(slot));
+            break;
+
+        default:
+            wrongType(slot, "DECIMAL!");
+        }
+    }
+
+    template <class T>
+    static typename std::enable_if<std::is_base_of<AnyValue, T>::value>::type
+    get(T & value, REBVAL * slot, RenEngineHandle engine) {
+        Borrowed<AnyValue> view (slot, engine);
+        value = static_cast<T>(static_cast<AnyValue const &>(view));
+    }
+
+    template <class T>
+    static typename std::enable_if<Marshal<T>::defined>::type
+    get(T & record, REBVAL * slot, RenEngineHandle engine) {
+        if (cellKind(slot) != Kind::Object)
+            wrongType(slot, "OBJECT!");
+        getFields(record, slot, engine);
+    }
+
+    template <class T>
+    static void get(optional<T> & opt, REBVAL * slot, RenEngineHandle engine) {
+        if (slot == nullptr || cellKind(slot) == Kind::Blank) {
+            opt = nullopt;
+            return;
+        }
+        T value;
+        get(value, slot, engine);
+        opt = std::move(value);
+    }
+
+    template <class T>
+    static void get(
+        std::vector<T> & items, REBVAL * slot, RenEngineHandle engine
+    ) {
+        size_t len = arrayLength(slot);
+        REBVAL * item = arrayHead(slot);
+
+        items.clear();
+        items.reserve(len);
+        for (size_t i = 0; i < len; ++i) {
+            // Read into a T, as std::vector<bool>'s back() is a proxy
+            //
+            T value {};
+            get(value, item, engine);
+            items.push_back(std::move(value));
+            item = cellAt(item, 1);
+        }
+    }
+
+    template <class T>
+    static void getFields(
+        T & record, REBVAL const * object, RenEngineHandle engine
+    ){
+        REBVAL * slots[Marshal<T>::count];
+        objectSlots(slots, object, Marshal<T>::layout());
+        Marshal<T>::fields(record, FieldReader {slots, engine});
+    }
+
+    template <class T>
+    static void getPositional(
+        T & record, REBVAL const * array, RenEngineHandle engine
+    ) {
+        REBVAL * slots[Marshal<T>::count];
+
+        size_t len = arrayLength(array);
+        REBVAL * item = arrayHead(array);
+        for (size_t i = 0; i < Marshal<T>::count; ++i) {
+            slots[i] = i < len ? item : nullptr;
+            item = cellAt(item, 1);
+        }
+
+        Marshal<T>::fields(record, FieldReader {slots, engine});
+    }
+
+
+    // Entry points, which need AnyValue's friendship for blank_() and .cell
+
+    template <class T>
+    static Object toObject(T const & record, Engine * engine) {
+        auto result = AnyValue::blank_<Object>(engineHandle(engine));
+        put(result.cell, record);
+        return result;
+    }
+
+    template <class T>
+    static Block toBlock(T const & record, Engine * engine) {
+        auto result = AnyValue::blank_<Block>(engineHandle(engine));
+        putFields(putBlock(result.cell, Marshal<T>::count), record);
+        return result;
+    }
+
+    template <class T>
+    static Block toObjects(std::vector<T> const & records, Engine * engine) {
+        auto result = AnyValue::blank_<Block>(engineHandle(engine));
+        put(result.cell, records);
+        return result;
+    }
+
+    template <class T>
+    static T fromObject(AnyContext const & object) {
+        T record;
+        getFields(record, object.cell, object.origin);
+        return record;
+    }
+
+    template <class T>
+    static T fromBlock(AnyArray const & array) {
+        T record;
+        getPositional(record, array.cell, array.origin);
+        return record;
+    }
+
+    template <class T>
+    static std::vector<T> fromObjects(AnyArray const & array) {
+        std::vector<T> records;
+        get(records, array.cell, array.origin);
+        return records;
+    }
+
+private:
+    struct FieldWriter {
+        REBVAL * slot;
+
+        template <class F>
+        void operator()(F const & field) {
+            put(slot, field);
+            slot = cellAt(slot, 1);
+        }
+    };
+
+    struct FieldReader {
+        REBVAL * const * slots;
+        RenEngineHandle engine;
+
+        template <class F>
+        void operator()(F & field) {
+            REBVAL * slot = *slots++;
+            if (slot != nullptr)
+                get(field, slot, engine);
+        }
+
+        template <class F>
+        void operator()(optional<F> & field) {
+            get(field, *slots++, engine); // missing key means nullopt
+        }
+    };
+};
+
+} // end namespace internal
+
+
+
+//
+// CONVERSIONS
+//
+
+template <class T>
+Object toObject(T const & record, Engine * engine = nullptr) {
+    static_assert(Marshal<T>::defined, "Use RENCPP_MARSHAL on the type");
+    return internal::Marshaller::toObject(record, engine);
+}
+
+template <class T>
+Block toBlock(T const & record, Engine * engine = nullptr) {
+    static_assert(Marshal<T>::defined, "Use RENCPP_MARSHAL on the type");
+    return internal::Marshaller::toBlock(record, engine);
+}
+
+template <class T>
+Block toObjects(std::vector<T> const & records, Engine * engine = nullptr) {
+    static_assert(Marshal<T>::defined, "Use RENCPP_MARSHAL on the type");
+    return internal::Marshaller::toObjects(records, engine);
+}
+
+template <class T>
+T fromObject(AnyContext const & object) {
+    static_assert(Marshal<T>::defined, "Use RENCPP_MARSHAL on the type");
+    return internal::Marshaller::fromObject<T>(object);
+}
+
+template <class T>
+T fromBlock(AnyArray const & array) {
+    static_assert(Marshal<T>::defined, "Use RENCPP_MARSHAL on the type");
+    return internal::Marshaller::fromBlock<T>(array);
+}
+
+template <class T>
+std::vector<T> fromObjects(AnyArray const & array) {
+    static_assert(Marshal<T>::defined, "Use RENCPP_MARSHAL on the type");
+    return internal::Marshaller::fromObjects<T>(array);
+}
+
+} // end namespace ren
+
+
+
+//
+// FIELD LIST MACRO
+//
+
+#define RENCPP_PP_COUNT_( \
+    _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, \
+    N, ... \
+) N
+
+#define RENCPP_PP_COUNT(...) \
+    RENCPP_PP_COUNT_(__VA_ARGS__, \
+        16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+
+#define RENCPP_PP_CAT_(a, b) a ## b
+#define RENCPP_PP_CAT(a, b) RENCPP_PP_CAT_(a, b)
+
+#define RENCPP_PP_EACH_1(m, x) m(x)
+#define RENCPP_PP_EACH_2(m, x, ...) m(x) RENCPP_PP_EACH_1(m, __VA_ARGS__)
+#define RENCPP_PP_EACH_3(m, x, ...) m(x) RENCPP_PP_EACH_2(m, __VA_ARGS__)
+#define RENCPP_PP_EACH_4(m, x, ...) m(x) RENCPP_PP_EACH_3(m, __VA_ARGS__)
+#define RENCPP_PP_EACH_5(m, x, ...) m(x) RENCPP_PP_EACH_4(m, __VA_ARGS__)
+#define RENCPP_PP_EACH_6(m, x, ...) m(x) RENCPP_PP_EACH_5(m, __VA_ARGS__)
+#define RENCPP_PP_EACH_7(m, x, ...) m(x) RENCPP_PP_EACH_6(m, __VA_ARGS__)
+#define RENCPP_PP_EACH_8(m, x, ...) m(x) RENCPP_PP_EACH_7(m, __VA_ARGS__)
+#define RENCPP_PP_EACH_9(m, x, ...) m(x) RENCPP_PP_EACH_8(m, __VA_ARGS__)
+#define RENCPP_PP_EACH_10(m, x, ...) m(x) RENCPP_PP_EACH_9(m, __VA_ARGS__)
+#define RENCPP_PP_EACH_11(m, x, ...) m(x) RENCPP_PP_EACH_10(m, __VA_ARGS__)
+#define RENCPP_PP_EACH_12(m, x, ...) m(x) RENCPP_PP_EACH_11(m, __VA_ARGS__)
+#define RENCPP_PP_EACH_13(m, x, ...) m(x) RENCPP_PP_EACH_12(m, __VA_ARGS__)
+#define RENCPP_PP_EACH_14(m, x, ...) m(x) RENCPP_PP_EACH_13(m, __VA_ARGS__)
+#define RENCPP_PP_EACH_15(m, x, ...) m(x) RENCPP_PP_EACH_14(m, __VA_ARGS__)
+#define RENCPP_PP_EACH_16(m, x, ...) m(x) RENCPP_PP_EACH_15(m, __VA_ARGS__)
+
+#define RENCPP_PP_EACH(m, ...) \
+    RENCPP_PP_CAT(RENCPP_PP_EACH_, RENCPP_PP_COUNT(__VA_ARGS__))( \
+        m, __VA_ARGS__ \
+    )
+
+#define RENCPP_MARSHAL_NAME_(field) #field,
+#define RENCPP_MARSHAL_FIELD_(field) visitor(record.field);
+
+#define RENCPP_MARSHAL(Type, ...) \
+    namespace ren { \
+    template <> \
+    struct Marshal<Type> { \
+        static constexpr bool defined = true; \
+        static constexpr size_t count = RENCPP_PP_COUNT(__VA_ARGS__); \
+        \
+        static internal::RecordLayout & layout() { \
+            static char const * const names[] = { \
+                RENCPP_PP_EACH(RENCPP_MARSHAL_NAME_, __VA_ARGS__) \
+            }; \
+            static internal::RecordLayout instance (names, count); \
+            return instance; \
+        } \
+        \
+        template <class V> \
+        static void fields(Type const & record, V && visitor) { \
+            RENCPP_PP_EACH(RENCPP_MARSHAL_FIELD_, __VA_ARGS__) \
+        } \
+        \
+        template <class V> \
+        static void fields(Type & record, V && visitor) { \
+            RENCPP_PP_EACH(RENCPP_MARSHAL_FIELD_, __VA_ARGS__) \
+        } \
+    }; \
+    }
+
+#endif
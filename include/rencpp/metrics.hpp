@@ -0,0 +1,258 @@
+#ifndef RENCPP_METRICS_HPP
+#define RENCPP_METRICS_HPP
+
+//
+// metrics.hpp
+// This file is part of RenCpp
+// Copyright (C) 2015-2018 HostileFork.com
+//
+// Licensed under the Boost License, Version 1.0 (the "License")
+//
+//      http://www.boost.org/LICENSE_1_0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.  See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// See http://rencpp.hostilefork.com for more information on this project
+//
+
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+namespace ren {
+
+
+//
+// METRICS REGISTRY
+//
+
+//
+// A service that embeds an engine can't say much about it to a monitoring
+// system: how many evaluations it ran, how long they took, how hard the
+// garbage collector is working.  ren::metrics keeps counts of those as the
+// binding goes about its business, and renders them on demand in the
+// OpenMetrics text format (which Prometheus scrapes):
+//
+//     # TYPE ren_evaluations counter
+//     # HELP ren_evaluations Evaluations and applications through RenCpp
+//     ren_evaluations_total 1020
+//     ...
+//     # EOF
+//
+// Serving that text from an HTTP endpoint is left to the host program:
+//
+//     response.body = ren::metrics.openMetrics();
+//     response.contentType = ren::Metrics::contentType;
+//
+// The binding's own metrics are members, so the code that updates them does
+// no lookup.  A host can register its own under other names, and they are
+// rendered along with the built-in ones:
+//
+//     ren::Counter & requests = ren::metrics.counter(
+//         "myapp_requests", "Requests handled"
+//     );
+//     requests.add();
+//
+// Updating a metric is a relaxed atomic operation, so it's safe from any
+// thread and cheap enough for the evaluator's paths.  Rendering may run
+// on any thread as well (e.g. a UI timer), and sees each value as of some
+// moment during the render.
+//
+
+class Counter {
+public:
+    Counter () : value (0) {}
+
+    Counter (Counter const & other) = delete;
+    Counter & operator= (Counter const & other) = delete;
+
+    void add(uint64_t amount = 1) {
+        value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    uint64_t get() const {
+        return value.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> value;
+};
+
+
+class Gauge {
+public:
+    Gauge () : value (0) {}
+
+    Gauge (Gauge const & other) = delete;
+    Gauge & operator= (Gauge const & other) = delete;
+
+    void add(int64_t amount = 1) {
+        value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    void subtract(int64_t amount = 1) {
+        value.fetch_sub(amount, std::memory_order_relaxed);
+    }
+
+    void set(int64_t amount) {
+        value.store(amount, std::memory_order_relaxed);
+    }
+
+    int64_t get() const {
+        return value.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<int64_t> value;
+};
+
+
+//
+// A histogram counts observations into buckets by fixed upper bounds, which
+// must be ascending.  An implicit last bucket (`+Inf`) takes what is above
+// all of them.
+//
+
+class Histogram {
+public:
+    explicit Histogram (std::vector<double> bounds);
+
+    Histogram (Histogram const & other) = delete;
+    Histogram & operator= (Histogram const & other) = delete;
+
+    void observe(double value);
+
+    struct Snapshot {
+        std::vector<double> bounds;
+        std::vector<uint64_t> cumulative; // one more than bounds, for +Inf
+        double sum;
+
+        uint64_t count() const { return cumulative.back(); }
+    };
+
+    Snapshot snapshot() const;
+
+private:
+    std::vector<double> bounds;
+    std::unique_ptr<std::atomic<uint64_t>[]> buckets;
+    std::atomic<double> sum;
+};
+
+
+class Metrics {
+public:
+    Metrics ();
+
+    Metrics (Metrics const & other) = delete;
+    Metrics & operator= (Metrics const & other) = delete;
+
+public:
+    // What to send as the Content-Type of the openMetrics() text
+    //
+    static char const * const contentType;
+
+    // Registering a name that is already registered as the same kind of
+    // metric gives back the existing one (so independent pieces of code can
+    // share it).  A name that isn't valid for OpenMetrics, or that is taken
+    // by another kind of metric, throws std::invalid_argument.
+    //
+    Counter & counter(std::string const & name, std::string const & help);
+
+    Gauge & gauge(std::string const & name, std::string const & help);
+
+    Histogram & histogram(
+        std::string const & name,
+        std::string const & help,
+        std::vector<double> bounds
+    );
+
+    // For a count that something else keeps already, `read` is called at
+    // render time instead of keeping a copy of it up to date.
+    //
+    void sampledCounter(
+        std::string const & name,
+        std::string const & help,
+        std::function<uint64_t ()> read
+    );
+
+public:
+    std::string openMetrics();
+
+    void writeOpenMetrics(std::ostream & os);
+
+public:
+    // Calls to constructOrApplyInitialize() that apply (runtime(...),
+    // Function calls, AnyValue::apply()), and how long each took.  An
+    // evaluation that fails with an error is counted but not timed.
+    //
+    Counter evaluations;
+    Histogram applySeconds;
+
+    // UTF-8 bytes of source text handed to the scanner for loading
+    //
+    Counter scannedBytes;
+
+    // Invocations of C++ code through ren::Function
+    //
+    Counter nativeCalls;
+
+    // AnyValue cells currently allocated.  Each is a root for the garbage
+    // collector, so this is how much C++ is keeping alive.
+    //
+    Gauge liveRoots;
+
+    // Bytes written to an engine's output stream (PRINT and such)
+    //
+    Counter outputBytes;
+
+    // (ren_gc_cycles is read from the runtime's own statistics)
+
+private:
+    enum class Kind { Counter, Gauge, Histogram, Sampled };
+
+    struct Family {
+        std::string name;
+        std::string help;
+        Kind kind;
+        void * metric; // Counter, Gauge or Histogram, per the kind
+        std::function<uint64_t ()> read;
+    };
+
+    Family * find(std::string const & name, Kind kind);
+
+    void add(
+        std::string const & name,
+        std::string const & help,
+        Kind kind,
+        void * metric,
+        std::function<uint64_t ()> read = nullptr
+    );
+
+    std::mutex mutex;
+    std::vector<Family> families; // rendered in order of registration
+
+    // Registered metrics are allocated separately, so references handed out
+    // stay good as more are added
+    //
+    std::vector<std::unique_ptr<Counter>> counters;
+    std::vector<std::unique_ptr<Gauge>> gauges;
+    std::vector<std::unique_ptr<Histogram>> histograms;
+};
+
+
+extern Metrics metrics;
+
+} // end namespace ren
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef RENCPP_MOLD_HPP
+#define RENCPP_MOLD_HPP
+
+//
+// mold.hpp
+// This file is part of RenCpp
+// Copyright (C) 2015-2018 HostileFork.com
+//
+// Licensed under the Boost License, Version 1.0 (the "License")
+//
+//      http://www.boost.org/LICENSE_1_0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.  See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// See http://rencpp.hostilefork.com for more information on this project
+//
+//=////////////////////////////////////////////////////////////////////////=//
+//
+// A UI that shows a value in a table cell or a log line only has room for
+// the first hundred characters or so, but `runtime("mold", value)` molds all
+// of it first.  For a block with a million items that's megabytes of work
+// (and memory) to throw almost all of it away.
+//
+// ren::mold() takes limits, and stops molding once it has enough:
+//
+//     MoldLimits limits;
+//     limits.maxBytes = 80;
+//     limits.maxDepth = 2;
+//
+//     Molded molded = mold(hugeBlock, limits);
+//     // molded.text is e.g. `[1 2 [a [...] b] 3 4 5 6 7 8 9 10 11 12...`
+//
+// The limits are:
+//
+// * maxBytes - the UTF-8 text is cut at this length (on a codepoint
+//   boundary) and the ellipsis is added after it.
+//
+// * maxElements - once this many values have been molded (counting blocks
+//   as well as their items), the rest is shown as the ellipsis, e.g.
+//   `[1 2 [3 4 ...]]`.
+//
+// * maxDepth - how many levels of blocks and groups to show.  Those nested
+//   deeper are shown as `[...]` or `(...)`.
+//
+// Zero means "no limit", and that is the default for all three.
+//
+// Only BLOCK!, GROUP!, and the string and binary types are molded in bounded
+// time.  Other values (e.g. a huge OBJECT!) are molded whole and then cut.
+//
+// !!! Blocks are walked from their index and shown in the plain MOLD form
+// even when `all` is set, so a block not at its head won't mold as the
+// construction syntax MOLD/ALL would give for it.
+//
+// To show part of a large block, e.g. as a "page" in a UI with a scrollbar,
+// use moldRange() to mold just the items from a 0-based offset:
+//
+//     Molded page = moldRange(hugeBlock, 1000, 100); // items 1000-1099
+//
+// The items are separated by spaces without the surrounding brackets, and
+// the limits apply to the page as a whole.
+//
+
+#include <string>
+
+#include "value.hpp"
+#include "arrays.hpp"
+
+
+namespace ren {
+
+struct MoldLimits {
+    size_t maxBytes;
+    size_t maxElements;
+    size_t maxDepth;
+
+    // Added where something was left out
+    //
+    char const * ellipsis;
+
+    // Use the MOLD/ALL construction syntax (e.g. for NONE vs. `none`)
+    //
+    bool all;
+
+    MoldLimits () :
+        maxBytes (0),
+        maxElements (0),
+        maxDepth (0),
+        ellipsis ("..."),
+        all (false)
+    {
+    }
+};
+
+
+struct Molded {
+    std::string text;
+
+    // Whether any limit was hit, i.e. whether the text is not all of the
+    // value's mold
+    //
+    bool truncated;
+};
+
+
+Molded mold(AnyValue const & value, MoldLimits const & limits = MoldLimits {});
+
+Molded moldRange(
+    AnyArray const & array,
+    size_t offset,
+    size_t count,
+    MoldLimits const & limits = MoldLimits {}
+);
+
+} // end namespace ren
+
+#endif
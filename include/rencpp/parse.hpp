@@ -0,0 +1,122 @@
+#ifndef RENCPP_PARSE_HPP
+#define RENCPP_PARSE_HPP
+
+//
+// parse.hpp
+// This file is part of RenCpp
+// Copyright (C) 2015-2018 HostileFork.com
+//
+// Licensed under the Boost License, Version 1.0 (the "License")
+//
+//      http://www.boost.org/LICENSE_1_0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.  See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// See http://rencpp.hostilefork.com for more information on this project
+//
+//=////////////////////////////////////////////////////////////////////////=//
+//
+// Saying `runtime("parse", input, rule)` costs more than the parse itself
+// when the input is small: the call is aggregated into a new block, PARSE is
+// looked up by name, and every word in the rule that names a sub-rule or a
+// charset is looked up again each time PARSE reaches it.
+//
+// A ren::ParseRule does that work once.  It takes a private deep copy of the
+// rule block and replaces each word that refers to a BLOCK!, BITSET!, CHAR!,
+// or string with the value itself, so running it is a walk over values with
+// no variable lookups.  Words PARSE treats as keywords are left alone, as
+// are the targets of SET and COPY, the argument of QUOTE, and words whose
+// values aren't rules (e.g. integers, which are repeat counts).
+//
+//     runtime("digit: charset {0123456789}");
+//     ParseRule number {Block {"some digit"}};
+//
+//     for (auto & record : records)
+//         if (number.matches(BorrowedString {record}))
+//             ...
+//
+// Since lookups happen at construction, changing a variable afterwards does
+// not change what an existing ParseRule matches.  Recursive rules work, as
+// each block is copied only once and references to it are shared.
+//
+// PARSE itself is fetched from LIB, so it is unaffected by a `parse` that is
+// redefined in the user context.
+//
+// To get matches out of a rule without COPY making a new string for each one
+// and the C++ code reading the variable back, use ParseRule::action():
+//
+//     std::vector<std::pair<size_t, size_t>> words;
+//
+//     ParseRule tokenizer {Block {
+//         "some [",
+//             ParseRule::action(
+//                 Block {"some letter"},
+//                 [&](AnySeries const &, size_t start, size_t end) {
+//                     words.emplace_back(start, end);
+//                 }
+//             ),
+//             "| skip",
+//         "]"
+//     }};
+//
+// The callback runs each time its sub-rule matches, and receives the series
+// being parsed with the 0-based offsets of the match's start and end.
+//
+// !!! Unbound words are reported when the rule is built instead of when
+// PARSE reaches them, which is stricter than PARSE is about rules that are
+// never reached.
+//
+
+#include <functional>
+
+#include "value.hpp"
+#include "series.hpp"
+#include "arrays.hpp"
+
+
+namespace ren {
+
+class ParseRule {
+public:
+    explicit ParseRule (Block const & rule);
+
+public:
+    // PARSE's result; a LOGIC! unless the rule used RETURN or ACCEPT
+    //
+    optional<AnyValue> operator()(AnySeries const & input) const;
+
+    bool matches(AnySeries const & input) const {
+        optional<AnyValue> result = (*this)(input);
+        return result && result->isTruthy();
+    }
+
+    // The resolved rule as PARSE sees it.  It may contain cycles if the rule
+    // was recursive.
+    //
+    Block const & block() const { return compiled; }
+
+public:
+    // `input` is positioned at `start`; if you keep it past the callback,
+    // note that it is the series being parsed and not a copy.
+    //
+    using Callback = std::function<
+        void (AnySeries const & input, size_t start, size_t end)
+    >;
+
+    // Makes a rule that matches `rule` and then calls `callback`, for
+    // splicing into a larger rule.
+    //
+    static Block action(AnyValue const & rule, Callback const & callback);
+
+private:
+    Block compiled;
+    AnyValue parser;
+};
+
+} // end namespace ren
+
+#endif
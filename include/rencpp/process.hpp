@@ -0,0 +1,113 @@
+#ifndef RENCPP_PROCESS_HPP
+#define RENCPP_PROCESS_HPP
+
+//
+// process.hpp
+// This file is part of RenCpp
+// Copyright (C) 2015-2018 HostileFork.com
+//
+// Licensed under the Boost License, Version 1.0 (the "License")
+//
+//      http://www.boost.org/LICENSE_1_0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.  See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// See http://rencpp.hostilefork.com for more information on this project
+//
+//=////////////////////////////////////////////////////////////////////////=//
+//
+// Running a command by typing it into an interactive shell means working
+// out where its output ends by watching for the prompt, and asking the
+// shell again for `$?` to get its exit status.  Every command costs a
+// round trip through the shell, and stdout and stderr arrive mixed.
+//
+// ren::Subprocess starts the program itself, with a pipe for each of its
+// standard input, output and error:
+//
+//     int status = Subprocess::run(
+//         {"git", "status", "--short"},
+//         [&](Subprocess::Channel channel, char const * data, size_t size) {
+//             if (channel == Subprocess::Channel::Output)
+//                 lines.append(data, size);
+//         }
+//     );
+//
+// Output is passed to the callback in chunks as it arrives, on the thread
+// that called run().  run() returns when the process has exited and both of
+// its pipes are drained.  The status is the exit code, or 128 plus the
+// signal number if a signal killed the process (which is how shells report
+// it).  If the callback throws, the process is killed and the exception
+// propagates.
+//
+// The program is looked up on the PATH, and the arguments are passed as is,
+// so nothing needs quoting.  For shell features (pipelines, globbing), run
+// `/bin/sh -c "..."` explicitly.
+//
+// Subprocess::function() makes a FUNCTION! for scripts to do the same:
+//
+//     runtime("call-process: quote", Subprocess::function());
+//
+//     runtime(
+//         "log: copy {}",
+//         "status: call-process/output [{make} {-j4}] log"
+//     );
+//
+// /output and /error append to a STRING! or BINARY! as the chunks come in.
+// Without them, the output goes to the engine's output stream.  The result
+// is the exit status as an INTEGER!.
+//
+// !!! Requires POSIX fork() and pipes.  On Windows run() will throw; it
+// could be done with CreateProcess() and a thread per pipe.
+//
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "value.hpp"
+#include "function.hpp"
+
+
+namespace ren {
+
+class Subprocess {
+public:
+    enum class Channel { Output, Error };
+
+    using Callback = std::function<
+        void (Channel channel, char const * data, size_t size)
+    >;
+
+    // `input` is written to the process's standard input, which is then
+    // closed.  (So a program that reads its input to the end doesn't wait.)
+    //
+    static int run(
+        std::vector<std::string> const & arguments,
+        Callback const & callback,
+        std::string const & input = std::string {}
+    );
+
+    struct Captured {
+        int status;
+        std::string output;
+        std::string error;
+    };
+
+    static Captured capture(
+        std::vector<std::string> const & arguments,
+        std::string const & input = std::string {}
+    );
+
+    static Function function();
+
+private:
+    static void appendChunk(REBVAL * target, char const * data, size_t size);
+};
+
+} // end namespace ren
+
+#endif
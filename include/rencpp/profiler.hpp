@@ -0,0 +1,120 @@
+#ifndef RENCPP_PROFILER_HPP
+#define RENCPP_PROFILER_HPP
+
+//
+// profiler.hpp
+// This file is part of RenCpp
+// Copyright (C) 2015-2018 HostileFork.com
+//
+// Licensed under the Boost License, Version 1.0 (the "License")
+//
+//      http://www.boost.org/LICENSE_1_0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.  See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// See http://rencpp.hostilefork.com for more information on this project
+//
+
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+#include "common.hpp"
+
+
+namespace ren {
+
+
+//
+// SAMPLING PROFILER
+//
+
+//
+// If you point a native profiler (perf, Instruments, VTune...) at a program
+// that is running Ren code, what you get back is a deep recursion of the
+// evaluator's C functions.  That tells you the interpreter is busy, but not
+// *which script function* is making it busy.
+//
+// This profiler samples the evaluator's own stack of frames instead.  A
+// SIGPROF timer interrupts the evaluating thread, and the signal handler
+// walks the frame chain copying the label of each function invocation into
+// a preallocated buffer.  Nothing is allocated and no locks are taken in the
+// handler; the samples are aggregated later by whoever asks for the report.
+// Labels are kept to their first 31 bytes.
+//
+// The report is in the "folded stacks" format understood by flame graph
+// tools, one line per distinct stack with the root first:
+//
+//     do;main-loop;parse-record;parse 42
+//
+// Functions implemented in C++ through ren::Function are marked with a
+// `[c++]` suffix, so time spent in your own extensions stands apart from the
+// interpreted code that calls them.  Frames with no label (e.g. a function
+// value invoked directly out of a block) show up as `(anonymous)`.  Time
+// spent collecting garbage is charged to `(garbage collection)`, and a stack
+// that was caught changing (or was too deep to record) starts with `...`.
+//
+//     ren::profiler.start();
+//     runtime("do %my-slow-script.reb");
+//     ren::profiler.stop();
+//     std::ofstream("out.folded") << ren::profiler.folded();
+//
+// Only one thread's evaluator may be profiled at a time, and it is the thread
+// that called start().  The timer counts CPU time for the whole process, so
+// time other threads spend busy is lost to the profile.  Since the sample
+// buffer is of fixed size, a long profiling run should call drain() (or
+// folded()) periodically, otherwise samples past the buffer capacity are
+// dropped and counted as such.
+//
+// !!! Requires POSIX signals.  On Windows start() will throw; a watcher
+// thread which suspends the evaluator thread could be used there instead.
+//
+
+class Profiler {
+public:
+    Profiler ();
+
+    Profiler (Profiler const & other) = delete;
+    Profiler & operator= (Profiler const & other) = delete;
+
+    ~Profiler ();
+
+public:
+    void start(
+        std::chrono::microseconds interval = std::chrono::microseconds {1000}
+    );
+
+    void stop();
+
+    bool isRunning() const;
+
+    // Moves the raw samples out of the lock-free buffer and merges them into
+    // the aggregated stack counts.  Safe to call while profiling is running.
+    //
+    void drain();
+
+    // Forget all aggregated counts (and any samples not yet drained)
+    //
+    void reset();
+
+    size_t sampleCount() const;
+
+    size_t droppedCount() const;
+
+public:
+    std::string folded();
+
+    void writeFolded(std::ostream & os);
+};
+
+
+extern Profiler profiler;
+
+} // end namespace ren
+
+#endif
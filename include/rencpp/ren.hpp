@@ -47,6 +47,55 @@
 #include "image.hpp"
 
 
+//
+// KIND-SWITCHED DISPATCH
+//
+
+#include "visit.hpp"
+
+
+//
+// STRUCT MARSHALLING
+//
+
+#include "marshal.hpp"
+
+
+//
+// PRECOMPILED PARSE RULES
+//
+
+#include "parse.hpp"
+
+
+//
+// BOUNDED MOLDING
+//
+
+#include "mold.hpp"
+
+
+//
+// SUBPROCESSES
+//
+
+#include "process.hpp"
+
+
+//
+// STREAMING RESULTS FROM SCRIPTS
+//
+
+#include "generator.hpp"
+
+
+//
+// SCHEDULING SCRIPTS FROM MANY REQUESTERS
+//
+
+#include "scheduler.hpp"
+
+
 //
 // INCLUDE REBOL OR RED RUNTIME INSTANCE
 //
@@ -69,4 +118,8 @@
 
 #include "helpers.hpp"
 
+#include "profiler.hpp"
+
+#include "metrics.hpp"
+
 #endif
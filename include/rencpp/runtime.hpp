@@ -84,6 +84,14 @@ public:
         );
     }
 
+    // Like evaluate(), but errors, throws, and halts are reported in the
+    // result instead of as C++ exceptions (see notes in %error.hpp)
+    //
+    static Evaluation tryEvaluate(
+        std::initializer_list<internal::Loadable> loadables,
+        Engine * engine = nullptr
+    );
+
     // Has ambiguity error from trying to turn the nullptr into a Loadable;
     // investigate what it is about the static method that has this problem
 
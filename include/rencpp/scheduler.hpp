@@ -0,0 +1,193 @@
+#ifndef RENCPP_SCHEDULER_HPP
+#define RENCPP_SCHEDULER_HPP
+
+//
+// scheduler.hpp
+// This file is part of RenCpp
+// Copyright (C) 2015-2018 HostileFork.com
+//
+// Licensed under the Boost License, Version 1.0 (the "License")
+//
+//      http://www.boost.org/LICENSE_1_0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.  See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// See http://rencpp.hostilefork.com for more information on this project
+//
+//=////////////////////////////////////////////////////////////////////////=//
+//
+// An engine evaluates one thing at a time.  A host that takes requests from
+// many places (network connections, UI actions) has them queue up behind
+// whatever is running, so one slow script keeps quick interactive requests
+// waiting for as long as it takes.
+//
+// A ren::Scheduler runs submitted scripts on one engine, by priority.  Other
+// threads submit source text and get a ren::Task to poll, await or cancel:
+//
+//     Task task = scheduler.submit("render-report", Scheduler::Background);
+//     ...
+//     if (task.poll() == Task::Status::Waiting) ...
+//
+// while the thread that evaluates (the one that made the Scheduler) runs
+// them with run() or runPending().
+//
+// A running script is interrupted at checkpoints to let waiting tasks in.
+// A task waiting with a higher priority gets in at the next checkpoint.
+// One with the same priority gets in at the first checkpoint after the
+// running task has had `slice` of time.  Lower priorities wait until the
+// running task finishes.  Among waiting tasks of the same priority it's
+// first come, first served.
+//
+// !!! Ideally a task would be paused between any two evaluator steps and
+// resumed later.  But the runtime keeps one stack of frames (and one data
+// stack, and one chain of traps), and tasks can't get their own.  So the
+// task that gets in runs *on top of* the one interrupted, which continues
+// when it finishes.  Such a task may be interrupted itself, up to a depth of
+// MaxNesting.  It also means a checkpoint has to be a moment when the
+// evaluator calls out to the host.  Every ren::Function call is a
+// checkpoint, as is the Scheduler's own `checkpoint` function.  A script
+// that loops without calling into C++ can't be interrupted (except with
+// cancel()), so hand it `checkpoint` to call in its loop:
+//
+//     runtime("checkpoint: quote", scheduler.checkpoint);
+//
+// Values (the results of tasks) are used on the evaluating thread, as with
+// any other values.  The Scheduler lets go of its hold on a finished task's
+// result there too, so a Task handle may be dropped on any thread.
+//
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "value.hpp"
+#include "function.hpp"
+#include "error.hpp"
+
+
+namespace ren {
+
+class Scheduler;
+
+class Task {
+public:
+    enum class Status {
+        Waiting,
+        Running, // (or interrupted by a task running on top of it)
+        Completed,
+        Thrown,
+        Errored,
+        Cancelled // by cancel(), or halted some other way
+    };
+
+    // Safe from any thread
+    //
+    Status poll() const;
+
+    // Waits for the task to finish, and gives its final status.  On the
+    // evaluating thread, this runs waiting tasks (by priority) until it does.
+    // Safe from any thread, but throws std::logic_error if this task is
+    // already running beneath the caller, as it can't finish until the
+    // caller returns.
+    //
+    Status await();
+
+    // A waiting task is dropped, and a running one is halted at its next
+    // checkpoint (or right away if nothing is running on top of it).
+    // Nothing happens to a task that has finished.  Safe from any thread.
+    //
+    void cancel();
+
+    // What the task evaluated to, on the evaluating thread once it has
+    // finished.  (A task cancelled before it ran has a status of Halted.)
+    //
+    Evaluation const & result() const;
+
+    int priority() const;
+
+    // For fairness accounting: time spent waiting to start, and time spent
+    // running (not counting tasks that ran on top of it)
+    //
+    std::chrono::nanoseconds waitTime() const;
+
+    std::chrono::nanoseconds runTime() const;
+
+public:
+    struct State;
+
+private:
+    friend class Scheduler;
+
+    explicit Task (std::shared_ptr<State> state) :
+        state (std::move(state))
+    {
+    }
+
+    std::shared_ptr<State> state;
+};
+
+
+class Scheduler {
+public:
+    // Suggested priorities.  Any int will do; higher runs first.
+    //
+    static const int Background = -10;
+    static const int Normal = 0;
+    static const int Interactive = 10;
+
+    static const size_t MaxNesting = 16;
+
+    explicit Scheduler (
+        std::chrono::milliseconds slice = std::chrono::milliseconds {10}
+    );
+
+    Scheduler (Scheduler const & other) = delete;
+    Scheduler & operator= (Scheduler const & other) = delete;
+
+    // Tasks that haven't started are cancelled.  Must not be destroyed while
+    // any of its tasks are running.
+    //
+    ~Scheduler ();
+
+    // Queue source to be loaded and evaluated (in the user context).  Safe
+    // from any thread.
+    //
+    Task submit(std::string source, int priority = Normal);
+
+    // On the evaluating thread: run tasks until none are waiting
+    //
+    void runPending();
+
+    // On the evaluating thread: run tasks, waiting for more to be submitted
+    // when there are none, until stop() is called
+    //
+    void run();
+
+    // Makes run() return once the task it is running finishes.  Safe from
+    // any thread.
+    //
+    void stop();
+
+    // Does nothing but give the scheduler a checkpoint (see notes above)
+    //
+    Function checkpoint;
+
+public:
+    struct Core;
+
+private:
+    friend class Function; // its dispatcher makes every call a checkpoint
+
+    static void atCheckpoint();
+
+    std::shared_ptr<Core> core;
+};
+
+} // end namespace ren
+
+#endif
@@ -31,7 +31,7 @@ namespace internal {
 class AnySeries_ : public AnyValue {
 protected:
     friend class AnyValue;
-    AnySeries_ (Dont) noexcept : AnyValue (Dont::Initialize) {}
+    AnySeries_ (Dont dont) noexcept : AnyValue (dont) {}
     static bool isValid(REBVAL const * cell);
 
 public:
@@ -61,7 +61,7 @@ public:
 class AnySeries : public ren::internal::AnySeries_ {
 protected:
     friend class AnyValue;
-    AnySeries (Dont) noexcept : AnySeries_ (Dont::Initialize) {}
+    AnySeries (Dont dont) noexcept : AnySeries_ (dont) {}
     static bool isValid(REBVAL const * cell);
 
     //
@@ -127,6 +127,11 @@ public:
 
     bool isEmpty() const { return length() == 0; }
 
+    // 0-based offset of this position from the head of the series (so it
+    // can index into the C++ data a BorrowedString was made from, say)
+    //
+    size_t index() const;
+
 
     // All series can be accessed by index, but there is no general rule
     // about any other way to index into them.  But if you have a base
@@ -19,9 +19,16 @@
 // See http://rencpp.hostilefork.com for more information on this project
 //
 
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+
 #include "value.hpp"
 #include "atoms.hpp"
 #include "series.hpp"
+#include "arrays.hpp"
+#include "function.hpp"
 
 namespace ren {
 
@@ -33,8 +40,15 @@ class AnyString : public AnySeries
 {
 protected:
     friend class AnyValue;
-    AnyString (Dont) noexcept : AnySeries (Dont::Initialize) {}
-    static bool isValid(REBVAL const * cell);
+    AnyString (Dont dont) noexcept : AnySeries (dont) {}
+    static bool isValid(REBVAL const * cell) {
+        Kind kind = internal::cellKind(cell);
+        return kind == Kind::String
+            || kind == Kind::File
+            || kind == Kind::Email
+            || kind == Kind::Url
+            || kind == Kind::Tag;
+    }
 
     // Friending doesn't seem to be enough for gcc 4.6, see SO writeup:
     //    http://stackoverflow.com/questions/32983193/
@@ -134,6 +148,118 @@ public:
         return iterator (temp);
     }
 
+
+public:
+    // Iterating with begin() and end() gives a Character value for each
+    // character, which is convenient but costs a cell and a type check per
+    // character.  For scanning text, codepoints() reads the series' storage
+    // directly:
+    //
+    //     for (char32_t c : text.codepoints())
+    //         ...
+    //
+    // The storage is read in place, so the string must not be modified
+    // (which might move it) while a codepoint_iterator is in use.
+    //
+    class codepoint_iterator {
+        friend class AnyString;
+
+        void const * data;
+        size_t index;
+        bool wide; // 16-bit characters, vs. Latin-1 bytes
+
+        codepoint_iterator (void const * data, size_t index, bool wide) :
+            data (data),
+            index (index),
+            wide (wide)
+        {
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = char32_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = char32_t const *;
+        using reference = char32_t;
+
+        char32_t operator*() const {
+            return wide
+                ? static_cast<std::uint16_t const *>(data)[index]
+                : static_cast<unsigned char const *>(data)[index];
+        }
+
+        codepoint_iterator & operator++() {
+            ++index;
+            return *this;
+        }
+
+        codepoint_iterator operator++(int) {
+            auto temp = *this;
+            ++index;
+            return temp;
+        }
+
+        bool operator==(codepoint_iterator const & other) const
+            { return index == other.index && data == other.data; }
+        bool operator!=(codepoint_iterator const & other) const
+            { return !(*this == other); }
+    };
+
+    struct codepoint_range {
+        codepoint_iterator first;
+        codepoint_iterator last;
+
+        codepoint_iterator begin() const { return first; }
+        codepoint_iterator end() const { return last; }
+    };
+
+    // From the string's position to its tail
+    //
+    codepoint_range codepoints() const;
+
+    // Replaces the contents of `out` with the codepoints from the string's
+    // position to its tail
+    //
+    void decodeInto(std::u32string & out) const;
+
+public:
+    // Searching and comparing without the cost of `runtime("find", ...)`,
+    // which builds a block and looks FIND up on every call.  Offsets are
+    // 0-based from the string's position, and `char const *` text is UTF-8.
+    //
+    // The caseless versions fold case the way Ren's `=` and FIND do, so
+    // `text.isEqualToCaseless("ABC")` agrees with `text = "ABC"`.
+    //
+    optional<size_t> find(AnyString const & needle, size_t from = 0) const;
+    optional<size_t> find(char const * needle, size_t from = 0) const;
+
+    optional<size_t> findCaseless(
+        AnyString const & needle, size_t from = 0
+    ) const;
+    optional<size_t> findCaseless(char const * needle, size_t from = 0) const;
+
+    bool isEqualToCaseless(AnyString const & other) const;
+    bool isEqualToCaseless(char const * text) const;
+
+    // The pieces between each `delimiter`, as new strings of the same type.
+    // Every delimiter ends a piece, so `a,,b` gives `["a" "" "b"]` and `a,`
+    // gives `["a" ""]`.
+    //
+    Block split(char32_t delimiter) const;
+
+    // The same for scripts, as FUNCTION!s to set words to.  The find is
+    // caseless unless /case is used, and gives the string at the match (as
+    // FIND does) or blank.
+    //
+    //     runtime("find-text: quote", AnyString::findFunction());
+    //     runtime("split-text: quote", AnyString::splitFunction());
+    //
+    //     runtime("find-text {The quick fox} {QUICK}"); // "quick fox"
+    //     runtime("split-text {a,b} #\",\""); // ["a" "b"]
+    //
+    static Function findFunction();
+    static Function splitFunction();
+
 public:
     template <class T = std::string>
     T spellingOf() const {
@@ -182,7 +308,7 @@ template <class C, CellFunction F>
 class AnyString_ : public AnyString {
 protected:
     friend class AnyValue;
-    AnyString_ (Dont) noexcept : AnyString (Dont::Initialize) {}
+    AnyString_ (Dont dont) noexcept : AnyString (dont) {}
 
 public:
     explicit AnyString_ (Engine * engine = nullptr) :
@@ -209,6 +335,17 @@ public:
 
 };
 
+
+#if REN_CLASSLIB_QT == 1
+
+// The characters of a string series from the cell's index, copied into a
+// QString's UTF-16 without going through UTF-8.  (So for a TAG! it's the
+// spelling, without the angle brackets.)
+//
+QString qStringFromCell(REBVAL const * cell);
+
+#endif
+
 } // end namespace internal
 
 
@@ -227,10 +364,12 @@ class String
     : public internal::AnyString_<String, &AnyString::initString>
 {
 protected:
-    static bool isValid(REBVAL const * cell);
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::String;
+    }
 
 protected:
-    String (Dont) noexcept : AnyString_ (Dont::Initialize) {}
+    String (Dont dont) noexcept : AnyString_ (dont) {}
     friend class AnyValue;
 
     // Only String allows you to use implicit construction from string
@@ -272,7 +411,9 @@ class Tag
     : public internal::AnyString_<Tag, &AnyString::initTag>
 {
 protected:
-    static bool isValid(REBVAL const * cell);
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::Tag;
+    }
 
 public:
     friend class AnyValue;
@@ -284,13 +425,83 @@ class Filename :
     public internal::AnyString_<Filename, &AnyString::initFilename>
 {
 protected:
-    static bool isValid(REBVAL const * cell);
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::File;
+    }
 
 public:
     friend class AnyValue;
     using AnyString_<Filename, &AnyString::initFilename>::AnyString_;
 };
 
+
+
+//
+// BORROWED STRING
+//
+
+//
+// Constructing a String from C++ text makes the scanner load it as source,
+// which copies it (and spends time looking for the closing brace).  That is
+// a poor way to begin a PARSE of a large buffer:
+//
+//     std::string log = readWholeFile(...);
+//     runtime("parse", log, rules); // scans and copies all of `log` first
+//
+// A BorrowedString is a STRING! whose series points at the caller's memory.
+// Making one is O(1) apart from a check that the text is ASCII, and it can
+// be passed anywhere a String can:
+//
+//     BorrowedString text {log};
+//     runtime("parse", text, rules);
+//
+// The caller's buffer must stay alive and unchanged for as long as the
+// BorrowedString does.  The series is locked (as LOCK does, which unlike
+// PROTECT can't be undone) so Ren code can't write into it.  If Ren code
+// kept a reference to the series (e.g. `saved: input`), then when the
+// BorrowedString is destroyed that series becomes empty, instead of
+// pointing at memory that may have been freed.
+//
+// !!! Ren-C's byte-sized strings are Latin-1, not UTF-8.  So if the text
+// has any bytes over 127 it can't be borrowed, and is decoded into an
+// ordinary copy instead.  isBorrowed() says which.  The series also needs a
+// NUL after the text: std::string has one, but for a pointer and a size the
+// caller has to say so with Terminator::Present, or the text is copied.
+//
+
+class BorrowedString final : public String {
+public:
+    enum class Terminator {
+        Unknown,
+        Present // data[size] is a NUL, owned by the caller like the rest
+    };
+
+    BorrowedString (
+        char const * data,
+        size_t size,
+        Terminator terminator = Terminator::Unknown,
+        Engine * engine = nullptr
+    );
+
+    explicit BorrowedString (
+        std::string const & str,
+        Engine * engine = nullptr
+    ) :
+        BorrowedString (str.c_str(), str.size(), Terminator::Present, engine)
+    {
+    }
+
+    BorrowedString (BorrowedString const & other) = delete;
+    BorrowedString & operator= (BorrowedString const & other) = delete;
+
+    ~BorrowedString () override;
+
+    bool isBorrowed() const { return series != nullptr; }
+
+private:
+    void * series; // REBSER* whose data is the caller's, or null if copied
+};
+
 } // end namespace ren
 
 #endif
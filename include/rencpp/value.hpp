@@ -35,6 +35,8 @@
 
 #include "hooks.h"
 
+#include "cell.hpp"
+
 
 
 namespace ren {
@@ -70,6 +72,8 @@ class AnyContext;
 
 class Engine;
 
+struct Evaluation;
+
 
 namespace internal {
     //
@@ -86,6 +90,15 @@ namespace internal {
     template <class R, class... Ts>
     class FunctionGenerator;
 
+    template <class R, class F>
+    class Visitor;
+
+    class Marshaller;
+
+    class Molder;
+
+    class Loader;
+
     // We want to be able to pass a Context to the constructors.  However, the
     // Context itself is a legal Ren type!  This "ContextWrapper" is used to
     // carry a context without itself being a candidate to be a Loadable.
@@ -226,6 +239,21 @@ protected:
     friend class Function; // needs to extract series from spec block
     friend class ren::internal::AnySeries_; // iterator state
 
+    template <class R, class F>
+    friend class ren::internal::Visitor; // reads cell to dispatch on kind
+
+    friend class ren::internal::Marshaller; // writes struct fields to cells
+
+    friend class ParseRule; // rewrites words in its copy of the rule
+
+    friend class ren::internal::Molder; // walks arrays to mold them partially
+
+    friend class ren::internal::Loader; // appends loadables' cells to arrays
+
+    friend class Date; // reads and writes arrays of dates in bulk
+
+    friend class Subprocess; // appends output to the series it is given
+
     REBVAL *cell;
 
     friend class internal::RebolHooks;
@@ -273,10 +301,15 @@ protected:
     // Call finishInit once the cell bits have been properly set up, so
     // that any tracking/refcounting/etc. can be added.
     //
+    // Dont::Allocate goes further and leaves `cell` null.  It is for the
+    // borrowed views handed out by ren::visit(), which point `cell` at a
+    // cell owned by someone else and null it again before destruction.
+    // Each derived class's Dont constructor must pass its argument along.
+    //
 
 protected:
-    enum class Dont {Initialize};
-    AnyValue (Dont);
+    enum class Dont {Initialize, Allocate};
+    AnyValue (Dont dont);
 
     bool tryFinishInit(RenEngineHandle engine);
 
@@ -346,6 +379,16 @@ protected:
         return result;
     }
 
+    // For friends that will write the cell's bits themselves after the
+    // value exists (and is hence already visible to the GC as a BLANK!)
+    //
+    template <class T>
+    static T blank_(RenEngineHandle engine) {
+        T result (Dont::Initialize);
+        result.finishInit(engine);
+        return result;
+    }
+
 
 public:
     static void toCell_(
@@ -410,9 +453,13 @@ public:
     //
     AnyValue (bool b, Engine * engine = nullptr) noexcept;
 
-    bool isTruthy() const;
+    bool isTruthy() const {
+        return !internal::cellIsFalsey(cell);
+    }
 
-    bool isFalsey() const;
+    bool isFalsey() const {
+        return internal::cellIsFalsey(cell);
+    }
 
     // http://stackoverflow.com/q/6242768/211160
     explicit operator bool() const;
@@ -685,7 +732,8 @@ protected:
         internal::Loadable const loadables[],
         size_t numLoadables,
         AnyValue * constructOutTypeIn,
-        AnyValue * applyOut
+        AnyValue * applyOut,
+        Evaluation * outcome = nullptr // report failures here, don't throw
     );
 };
 
@@ -748,7 +796,12 @@ class evaluation_throw : public std::exception {
 private:
     optional<AnyValue> thrownValue; // throw might not have a value, e.g. return
     optional<AnyValue> throwName;
-    std::string whatString;
+
+    // Molding a large thrown value is expensive, and most catchers of a
+    // throw are interested in the value and not a description of it...so
+    // the string is made only if what() gets called.
+    //
+    mutable std::string whatString;
 
 public:
     evaluation_throw (
@@ -758,27 +811,27 @@ public:
         thrownValue (value),
         throwName (name)
     {
-        if (name == nullopt) {
-            whatString = std::string("THROW:");
-            whatString += " ";
+    }
+
+    char const * what() const noexcept override {
+        if (!whatString.empty())
+            return whatString.c_str();
+
+        try {
+            whatString = throwName == nullopt ? "THROW: " : "THROW/NAME: ";
             if (thrownValue == nullopt)
                 whatString += "(no value)";
             else
                 whatString += to_string(*thrownValue);
+
+            if (throwName != nullopt) {
+                whatString += " ";
+                whatString += to_string(*throwName);
+            }
         }
-        else {
-            whatString = std::string("THROW/NAME:");
-            whatString += " ";
-            if (thrownValue == nullopt)
-                whatString += "(no value)";
-            else
-                whatString += to_string(*thrownValue);
-            whatString += " ";
-            whatString += to_string(*throwName);
+        catch (...) {
+            whatString = "ren::evaluation_throw";
         }
-    }
-
-    char const * what() const noexcept override {
         return whatString.c_str();
     }
 
@@ -861,6 +914,24 @@ public:
 #if REN_CLASSLIB_QT == 1
     Loadable (QString const & source);
 #endif
+
+protected:
+    // A nested brace list, e.g. the `{2, 3}` in `Block {1, {2, 3}}`.  The
+    // list's storage lives until the end of the full expression, so it is
+    // kept as-is and loaded in the same pass as the list it is inside.
+    //
+    Loadable (
+        Loadable const nested[],
+        size_t numNested,
+        CellFunction cellfun
+    );
+
+private:
+    friend class Loader;
+
+    Loadable const * nested = nullptr;
+    size_t numNested = 0;
+    CellFunction nestedCellFunction = nullptr; // null if not a brace list
 };
 
 //
@@ -886,20 +957,24 @@ public:
     using Loadable::Loadable;
 
     BlockLoadable () :
-        Loadable(BracesT{})
+        Loadable(nullptr, 0, BracesT::cellFunction())
     {
     }
 
     //
-    // If you get an error here such as "invalid use of
-    // void expression", it means that you tried to use
-    // a block type which does not support any implicit
-    // construction from curly braces.
+    // If you get an error here such as "incomplete type"
+    // or "cellFunction is not a member", it means that you
+    // tried to use a block type which does not support any
+    // implicit construction from curly braces.
     //
 
     BlockLoadable (std::initializer_list<BlockLoadable<BracesT>> loadables) :
-        Loadable(BracesT(loadables))
+        Loadable(loadables.begin(), loadables.size(), BracesT::cellFunction())
     {
+        static_assert(
+            sizeof(BlockLoadable<BracesT>) == sizeof(Loadable),
+            "Nested brace lists are walked as arrays of Loadable"
+        );
     }
 };
 
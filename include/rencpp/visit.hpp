@@ -0,0 +1,255 @@
+#ifndef RENCPP_VISIT_HPP
+#define RENCPP_VISIT_HPP
+
+//
+// visit.hpp
+// This file is part of RenCpp
+// Copyright (C) 2015-2018 HostileFork.com
+//
+// Licensed under the Boost License, Version 1.0 (the "License")
+//
+//      http://www.boost.org/LICENSE_1_0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.  See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// See http://rencpp.hostilefork.com for more information on this project
+//
+//=////////////////////////////////////////////////////////////////////////=//
+//
+// Code that interprets a dialect in C++ tends to look like this:
+//
+//     if (hasType<Integer>(item)) ...
+//     else if (hasType<Block>(item)) ...
+//     else if (hasType<AnyWord>(item)) ...
+//
+// Each test re-reads the cell, and the casts that follow them each allocate
+// a new cell to copy the value into.  ren::visit() reads the kind once and
+// jumps straight to the lambda for the most specific class of the value:
+//
+//     ren::visit(item, ren::overloaded(
+//         [&](Integer const & i) { total += static_cast<int>(i); },
+//         [&](Block const & b) { recurse(b); },
+//         [&](AnyWord const & w) { lookup(w); }, // Word, SetWord, Issue...
+//         [&](AnyValue const & v) { throw unexpected(v); }
+//     ));
+//
+// Ordinary overload resolution picks the handler, so a lambda for a base
+// class catches every kind beneath it that doesn't have a closer match.
+// There must be a handler accepting AnyValue, so every kind is covered.
+//
+// The argument is a *borrowed view*: it refers to the visited value's cell
+// without allocating one of its own, so it is only good for the duration of
+// the call.  Take the parameter by value instead of by reference if you need
+// to keep it, which makes an ordinary (owning) copy.
+//
+// All handlers must return the same type, which is what visit() returns.
+//
+// !!! The syntax is `overloaded(...)` and not C++17's `overloaded{...}`,
+// because RenCpp is C++11 and can't use deduction guides.
+//
+
+#include <cassert>
+#include <type_traits>
+#include <utility>
+
+#include "value.hpp"
+#include "atoms.hpp"
+#include "words.hpp"
+#include "series.hpp"
+#include "strings.hpp"
+#include "arrays.hpp"
+#include "context.hpp"
+#include "error.hpp"
+#include "function.hpp"
+#include "image.hpp"
+
+
+namespace ren {
+
+//
+// OVERLOAD SET HELPER
+//
+
+namespace internal {
+
+// C++11 can't expand a pack in a using-declaration, so the operator()s are
+// pulled in one level of inheritance at a time.
+
+template <class... Fs>
+struct Overloaded;
+
+template <class F>
+struct Overloaded<F> : F {
+    Overloaded (F && f) : F (std::move(f)) {}
+
+    using F::operator();
+};
+
+template <class F, class... Fs>
+struct Overloaded<F, Fs...> : F, Overloaded<Fs...> {
+    Overloaded (F && f, Fs &&... fs) :
+        F (std::move(f)),
+        Overloaded<Fs...> (std::move(fs)...)
+    {
+    }
+
+    using F::operator();
+    using Overloaded<Fs...>::operator();
+};
+
+} // end namespace internal
+
+
+template <class... Fs>
+internal::Overloaded<typename std::decay<Fs>::type...> overloaded(
+    Fs &&... fs
+) {
+    return internal::Overloaded<typename std::decay<Fs>::type...>(
+        typename std::decay<Fs>::type (std::forward<Fs>(fs))...
+    );
+}
+
+
+
+//
+// KIND TO CLASS MAPPING
+//
+
+namespace internal {
+
+// Most specific RenCpp class for each kind.  Kinds without a class of their
+// own map to the nearest category that will accept them, and AnyValue if
+// there is none.
+
+template <Kind K>
+struct KindClass { using type = AnyValue; };
+
+#define RENCPP_KIND_CLASS(kind, cls) \
+    template <> struct KindClass<Kind::kind> { using type = cls; }
+
+RENCPP_KIND_CLASS(Function, Function);
+RENCPP_KIND_CLASS(Word, Word);
+RENCPP_KIND_CLASS(SetWord, SetWord);
+RENCPP_KIND_CLASS(GetWord, GetWord);
+RENCPP_KIND_CLASS(LitWord, LitWord);
+RENCPP_KIND_CLASS(Refinement, Refinement);
+RENCPP_KIND_CLASS(Issue, AnyWord);
+RENCPP_KIND_CLASS(Path, Path);
+RENCPP_KIND_CLASS(SetPath, SetPath);
+RENCPP_KIND_CLASS(GetPath, GetPath);
+RENCPP_KIND_CLASS(LitPath, LitPath);
+RENCPP_KIND_CLASS(Group, Group);
+RENCPP_KIND_CLASS(Block, Block);
+RENCPP_KIND_CLASS(Binary, AnySeries);
+RENCPP_KIND_CLASS(String, String);
+RENCPP_KIND_CLASS(File, Filename);
+RENCPP_KIND_CLASS(Email, AnyString);
+RENCPP_KIND_CLASS(Url, AnyString);
+RENCPP_KIND_CLASS(Tag, Tag);
+RENCPP_KIND_CLASS(Image, Image);
+RENCPP_KIND_CLASS(Vector, AnySeries);
+RENCPP_KIND_CLASS(Object, Object);
+RENCPP_KIND_CLASS(Frame, AnyContext);
+RENCPP_KIND_CLASS(Module, AnyContext);
+RENCPP_KIND_CLASS(Error, Error);
+RENCPP_KIND_CLASS(Port, AnyContext);
+RENCPP_KIND_CLASS(Logic, Logic);
+RENCPP_KIND_CLASS(Integer, Integer);
+RENCPP_KIND_CLASS(Decimal, Float);
+RENCPP_KIND_CLASS(Char, Character);
+RENCPP_KIND_CLASS(Date, Date);
+RENCPP_KIND_CLASS(Blank, Blank);
+
+#undef RENCPP_KIND_CLASS
+
+
+
+//
+// BORROWED VIEW
+//
+
+//
+// A T that shares the cell of another value instead of owning one.  Nulling
+// the cell in the destructor keeps ~AnyValue() from freeing it.
+//
+
+template <class T>
+class Borrowed final : public T {
+public:
+    Borrowed (REBVAL * cell, RenEngineHandle engine) noexcept :
+        T (AnyValue::Dont::Allocate)
+    {
+        this->cell = cell;
+        this->origin = engine;
+    }
+
+    Borrowed (Borrowed const & other) = delete;
+    Borrowed & operator= (Borrowed const & other) = delete;
+
+    ~Borrowed () override {
+        this->cell = nullptr;
+    }
+};
+
+
+
+//
+// JUMP TABLE
+//
+
+template <class R, class F>
+class Visitor {
+public:
+    using Thunk = R (*)(REBVAL *, RenEngineHandle, F &);
+
+    template <std::size_t K>
+    static R thunk(REBVAL * cell, RenEngineHandle engine, F & f) {
+        using T = typename KindClass<static_cast<Kind>(K)>::type;
+
+        Borrowed<T> view (cell, engine);
+        return f(static_cast<T const &>(view));
+    }
+
+    template <std::size_t... Ks>
+    static Thunk const * table(utility::indices<Ks...>) {
+        static Thunk const thunks[] = { &thunk<Ks>... };
+        return thunks;
+    }
+
+    static R visit(AnyValue const & value, F & f) {
+        using Kinds = utility::make_indices<
+            static_cast<std::size_t>(Kind::Max)
+        >;
+
+        auto kind = static_cast<std::size_t>(internal::cellKind(value.cell));
+        assert(kind < static_cast<std::size_t>(Kind::Max));
+
+        return table(Kinds {})[kind](value.cell, value.origin, f);
+    }
+};
+
+} // end namespace internal
+
+
+
+//
+// VISIT
+//
+
+template <class F>
+auto visit(AnyValue const & value, F && f)
+    -> decltype(f(std::declval<AnyValue const &>()))
+{
+    using R = decltype(f(std::declval<AnyValue const &>()));
+    using Fn = typename std::remove_reference<F>::type;
+
+    return internal::Visitor<R, Fn>::visit(value, f);
+}
+
+} // end namespace ren
+
+#endif
@@ -30,8 +30,16 @@ namespace ren {
 class AnyWord : public AnyValue {
 protected:
     friend class AnyValue;
-    AnyWord (Dont) : AnyValue (Dont::Initialize) {}
-    static bool isValid(REBVAL const * cell);
+    AnyWord (Dont dont) : AnyValue (dont) {}
+    static bool isValid(REBVAL const * cell) {
+        Kind kind = internal::cellKind(cell);
+        return kind == Kind::Word
+            || kind == Kind::SetWord
+            || kind == Kind::GetWord
+            || kind == Kind::LitWord
+            || kind == Kind::Refinement
+            || kind == Kind::Issue;
+    }
 
     // Friending doesn't seem to be enough for gcc 4.6, see SO writeup:
     //    http://stackoverflow.com/questions/32983193/
@@ -140,7 +148,7 @@ template <class C, CellFunction F>
 class AnyWord_ : public AnyWord {
 protected:
     friend class AnyValue;
-    AnyWord_ (Dont) : AnyWord (Dont::Initialize) {}
+    AnyWord_ (Dont dont) : AnyWord (dont) {}
 
 public:
     explicit AnyWord_ (char const * cstr, Engine * engine = nullptr) :
@@ -202,7 +210,9 @@ class Word
     : public internal::AnyWord_<Word, &AnyWord::initWord>
 {
 protected:
-    static bool isValid(REBVAL const * cell);
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::Word;
+    }
 
 public:
     friend class AnyValue;
@@ -220,7 +230,9 @@ class SetWord
     : public internal::AnyWord_<SetWord, &AnyWord::initSetWord>
 {
 protected:
-    static bool isValid(REBVAL const * cell);
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::SetWord;
+    }
 
 public:
     friend class AnyValue;
@@ -240,7 +252,9 @@ class GetWord
     : public internal::AnyWord_<GetWord, &AnyWord::initGetWord>
 {
 protected:
-    static bool isValid(REBVAL const * cell);
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::GetWord;
+    }
 
 public:
     friend class AnyValue;
@@ -261,7 +275,9 @@ class LitWord
     : public internal::AnyWord_<LitWord, &AnyWord::initLitWord>
 {
 protected:
-    static bool isValid(REBVAL const * cell);
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::LitWord;
+    }
 
 public:
     friend class AnyValue;
@@ -277,7 +293,9 @@ class Refinement
     : public internal::AnyWord_<Refinement, &AnyWord::initRefinement>
 {
 protected:
-    static bool isValid(REBVAL const * cell);
+    static bool isValid(REBVAL const * cell) {
+        return internal::cellKind(cell) == Kind::Refinement;
+    }
 
 public:
     friend class AnyValue;
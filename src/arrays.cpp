@@ -11,43 +11,6 @@
 
 namespace ren {
 
-//
-// TYPE DETECTION
-//
-
-bool Block::isValid(REBVAL const * cell) {
-    return IS_BLOCK(cell);
-}
-
-bool Group::isValid(REBVAL const * cell) {
-    return IS_GROUP(cell);
-}
-
-bool Path::isValid(REBVAL const * cell) {
-    return IS_PATH(cell);
-}
-
-bool GetPath::isValid(REBVAL const * cell) {
-    return IS_GET_PATH(cell);
-}
-
-bool SetPath::isValid(REBVAL const * cell) {
-    return IS_SET_PATH(cell);
-}
-
-bool LitPath::isValid(REBVAL const * cell) {
-    return IS_LIT_PATH(cell);
-}
-
-bool AnyArray::isValid(REBVAL const * cell) {
-    return IS_BLOCK(cell)
-        || IS_GROUP(cell)
-        || IS_PATH(cell)
-        || IS_SET_PATH(cell)
-        || IS_GET_PATH(cell)
-        || IS_LIT_PATH(cell);
-}
-
 
 //
 // TYPE HEADER INITIALIZATION
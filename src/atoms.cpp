@@ -1,40 +1,26 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
 #include <stdexcept>
 
 #include "rencpp/value.hpp"
 #include "rencpp/atoms.hpp"
+#include "rencpp/arrays.hpp"
 #include "rencpp/engine.hpp"
+#include "rencpp/error.hpp"
 
 #include "common.hpp"
 
 
 namespace ren {
 
-bool Atom::isValid(REBVAL const * cell) {
-    // Will be more efficient when atom makes it formally into the
-    // Rebol base typesets.
-    //
-    // !!! Review handling of void.  It is not considered an atom, correct?
-    //
-    return (
-        IS_BLANK(cell)
-        || IS_LOGIC(cell)
-        || IS_CHAR(cell)
-        || IS_INTEGER(cell)
-        || IS_DECIMAL(cell)
-        || IS_DATE(cell)
-    );
-}
-
 
 
 //
 // BLANK
 //
 
-bool Blank::isValid(REBVAL const * cell) {
-    return IS_BLANK(cell);
-}
-
 AnyValue::AnyValue (blank_t, Engine * engine) noexcept :
     AnyValue (Dont::Initialize)
 {
@@ -53,18 +39,6 @@ AnyValue::AnyValue (blank_t, Engine * engine) noexcept :
 // LOGIC
 //
 
-bool Logic::isValid(REBVAL const * cell) {
-    return IS_LOGIC(cell);
-}
-
-bool AnyValue::isTruthy() const {
-    return IS_TRUTHY(cell);
-}
-
-bool AnyValue::isFalsey() const {
-    return IS_FALSEY(cell);
-}
-
 AnyValue::AnyValue (bool someBool, Engine * engine) noexcept :
     AnyValue (Dont::Initialize)
 {
@@ -77,20 +51,12 @@ AnyValue::AnyValue (bool someBool, Engine * engine) noexcept :
     finishInit(engine->getHandle());
 }
 
-Logic::operator bool() const {
-    return VAL_LOGIC(cell);
-}
-
 
 
 //
 // CHARACTER
 //
 
-bool Character::isValid(REBVAL const * cell) {
-    return IS_CHAR(cell);
-}
-
 AnyValue::AnyValue (char c, Engine * engine) :
     AnyValue (Dont::Initialize)
 {
@@ -153,10 +119,6 @@ Character::operator QChar () const {
 // INTEGER
 //
 
-bool Integer::isValid(REBVAL const * cell) {
-    return IS_INTEGER(cell);
-}
-
 AnyValue::AnyValue (int someInt, Engine * engine) noexcept :
     AnyValue (Dont::Initialize)
 {
@@ -169,22 +131,12 @@ AnyValue::AnyValue (int someInt, Engine * engine) noexcept :
     finishInit(engine->getHandle());
 }
 
-Integer::operator int() const {
-    // !!! How to correctly support 64-bit coercions?  Throw if out of range?
-    int i = VAL_INT32(cell);
-    return i;
-}
-
 
 
 //
 // FLOAT
 //
 
-bool Float::isValid(REBVAL const * cell) {
-    return IS_DECIMAL(cell);
-}
-
 AnyValue::AnyValue (double someDouble, Engine * engine) noexcept :
     AnyValue (Dont::Initialize)
 {
@@ -197,8 +149,26 @@ AnyValue::AnyValue (double someDouble, Engine * engine) noexcept :
     finishInit(engine->getHandle());
 }
 
-Float::operator double() const {
-    return VAL_DECIMAL(cell);
+
+
+//
+// TIME
+//
+
+Time::Time (std::chrono::nanoseconds duration, Engine * engine) :
+    Atom (Dont::Initialize)
+{
+    Init_Time_Nanoseconds(cell, duration.count());
+
+    if (engine == nullptr)
+        engine = &Engine::runFinder();
+
+    finishInit(engine->getHandle());
+}
+
+
+std::chrono::nanoseconds Time::duration() const {
+    return std::chrono::nanoseconds {VAL_NANO(cell)};
 }
 
 
@@ -207,8 +177,231 @@ Float::operator double() const {
 // DATE
 //
 
-bool Date::isValid(REBVAL const * cell) {
-    return IS_DATE(cell);
+//
+// A DATE! holds the local year, month, day and time of day, plus the zone it
+// is local to (in quarter hours).  So converting to or from an instant is
+// the zone offset plus counting days, for which these are Howard Hinnant's
+// algorithms for the proleptic Gregorian calendar:
+//
+//     http://howardhinnant.github.io/date_algorithms.html
+//
+
+namespace {
+
+std::int64_t const nanosPerDay = 86400LL * 1000000000LL;
+
+std::int64_t daysFromCivil(std::int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2 ? 1 : 0;
+    std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+    unsigned yoe = static_cast<unsigned>(year - era * 400);
+    unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5
+        + day - 1;
+    unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+
+void civilFromDays(
+    std::int64_t days,
+    std::int64_t & year,
+    unsigned & month,
+    unsigned & day
+) {
+    days += 719468;
+    std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    unsigned doe = static_cast<unsigned>(days - era * 146097);
+    unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned mp = (5 * doy + 2) / 153;
+
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = static_cast<std::int64_t>(yoe) + era * 400 + (month <= 2 ? 1 : 0);
+}
+
+
+// Checked before anything is written, so a bad zone or year throws without
+// leaving a half-made date behind
+//
+void writeDate(
+    RELVAL * out,
+    Date::time_point when,
+    std::chrono::minutes zone
+) {
+    if (
+        zone.count() % ZONE_MINS != 0
+        || std::abs(zone.count()) > MAX_ZONE * ZONE_MINS
+    ){
+        throw std::runtime_error(
+            "Date zone must be whole quarter hours within 15:00"
+        );
+    }
+
+    std::int64_t local = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        when.time_since_epoch() + zone
+    ).count();
+
+    std::int64_t days = local / nanosPerDay;
+    std::int64_t nano = local % nanosPerDay;
+    if (nano < 0) {
+        nano += nanosPerDay;
+        --days;
+    }
+
+    std::int64_t year;
+    unsigned month;
+    unsigned day;
+    civilFromDays(days, year, month, day);
+
+    if (year < 0 || year > MAX_YEAR)
+        throw std::runtime_error("Date year out of range for DATE!");
+
+    VAL_RESET_HEADER(out, REB_DATE);
+    VAL_YEAR(out) = static_cast<REBCNT>(year);
+    VAL_MONTH(out) = month;
+    VAL_DAY(out) = day;
+    VAL_ZONE(out) = static_cast<REBINT>(zone.count() / ZONE_MINS);
+    VAL_NANO(out) = nano;
+    SET_VAL_FLAGS(out, DATE_FLAG_HAS_TIME | DATE_FLAG_HAS_ZONE);
+}
+
+
+// Nanoseconds since the epoch only reach from 1677 to 2262, and a DATE! can
+// be any year up to MAX_YEAR.  A day is left spare at either end for the
+// time of day and the zone.
+//
+Date::time_point readDate(RELVAL const * date) {
+    std::int64_t days = daysFromCivil(
+        VAL_YEAR(date), VAL_MONTH(date), VAL_DAY(date)
+    );
+
+    std::int64_t const maxDays =
+        std::numeric_limits<std::int64_t>::max() / nanosPerDay - 1;
+
+    if (days < -maxDays || days > maxDays)
+        throw std::runtime_error(
+            "Date year out of range for std::chrono::system_clock"
+        );
+
+    std::int64_t nano = nanosPerDay * days;
+
+    if (GET_VAL_FLAG(date, DATE_FLAG_HAS_TIME))
+        nano += VAL_NANO(date);
+
+    if (GET_VAL_FLAG(date, DATE_FLAG_HAS_ZONE))
+        nano -= static_cast<std::int64_t>(VAL_ZONE(date)) * ZONE_MINS
+            * 60 * 1000000000LL;
+
+    return Date::time_point {
+        std::chrono::duration_cast<Date::time_point::duration>(
+            std::chrono::nanoseconds {nano}
+        )
+    };
+}
+
+} // end anonymous namespace
+
+
+Date::Date (time_point when, std::chrono::minutes zone, Engine * engine) :
+    Atom (Dont::Initialize)
+{
+    writeDate(cell, when, zone);
+
+    if (engine == nullptr)
+        engine = &Engine::runFinder();
+
+    finishInit(engine->getHandle());
+}
+
+
+Date::time_point Date::timePoint() const {
+    return readDate(cell);
+}
+
+
+bool Date::hasTime() const {
+    return GET_VAL_FLAG(cell, DATE_FLAG_HAS_TIME);
+}
+
+
+bool Date::hasZone() const {
+    return GET_VAL_FLAG(cell, DATE_FLAG_HAS_ZONE);
+}
+
+
+std::chrono::minutes Date::zone() const {
+    if (!hasZone())
+        return std::chrono::minutes {0};
+    return std::chrono::minutes {VAL_ZONE(cell) * ZONE_MINS};
+}
+
+
+std::vector<Date::time_point> Date::timePoints(AnyArray const & dates) {
+    REBARR * array = VAL_ARRAY(dates.cell);
+    REBCNT len = ARR_LEN(array);
+
+    // The index may be past the tail if the block was shortened after the
+    // value was taken; clamp it so len - start can't wrap around.
+    //
+    REBCNT start = std::min(VAL_INDEX(dates.cell), len);
+
+    std::vector<time_point> result;
+    result.reserve(len - start);
+
+    for (REBCNT n = start; n < len; ++n) {
+        RELVAL const * item = ARR_AT(array, n);
+        if (!IS_DATE(item))
+            throw bad_value_cast("Date::timePoints() given a non-DATE! item");
+        result.push_back(readDate(item));
+    }
+
+    return result;
+}
+
+
+Block Date::blockOf(
+    std::vector<time_point> const & times,
+    std::chrono::minutes zone,
+    Engine * engine
+) {
+    if (engine == nullptr)
+        engine = &Engine::runFinder();
+
+    // writeDate() throws on a bad zone or year, which mustn't happen inside
+    // the trap, so the block is filled with BLANK!s here and the dates are
+    // written over them once it is dropped.
+
+    DECLARE_LOCAL (out);
+
+    REBCTX * error;
+    struct Reb_State state;
+
+    PUSH_UNHALTABLE_TRAP(&error, &state);
+
+// The first time through the following code 'error' will be NULL, but...
+// `fail` can longjmp here, so 'error' won't be NULL *if* that happens!
+
+    if (error) {
+        AnyValue errorValue;
+        Init_Error(errorValue.cell, error);
+        throw evaluation_error {static_cast<Error>(errorValue)};
+    }
+
+    REBARR * array = Make_Array(static_cast<REBCNT>(times.size()));
+    for (size_t i = 0; i < times.size(); ++i)
+        Init_Blank(Alloc_Tail_Array(array));
+
+    Init_Block(out, array);
+
+    DROP_TRAP_SAME_STACKLEVEL_AS_PUSH(&state);
+
+    Block result = AnyValue::fromCell_<Block>(out, engine->getHandle());
+
+    RELVAL * item = ARR_HEAD(VAL_ARRAY(result.cell));
+    for (time_point const & when : times)
+        writeDate(item++, when, zone);
+
+    return result;
 }
 
 
@@ -0,0 +1,159 @@
+//
+// cell.cpp
+// This file is part of RenCpp
+// Copyright (C) 2015-2018 HostileFork.com
+//
+// Licensed under the Boost License, Version 1.0 (the "License")
+//
+//      http://www.boost.org/LICENSE_1_0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.  See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// See http://rencpp.hostilefork.com for more information on this project
+//
+//=////////////////////////////////////////////////////////////////////////=//
+//
+// %include/rencpp/cell.hpp describes the cell layout without including the
+// runtime's headers.  This file is the other half of that contract: it does
+// include them, and refuses to compile if the description has drifted.
+//
+
+#include <cassert>
+#include <cstddef>
+
+#include "rencpp/cell.hpp"
+
+#include "common.hpp"
+
+
+namespace ren {
+
+namespace internal {
+
+#define RENCPP_CHECK_KIND(ren_kind, reb_kind) \
+    static_assert( \
+        static_cast<int>(Kind::ren_kind) == static_cast<int>(reb_kind), \
+        "ren::Kind::" #ren_kind " doesn't match " #reb_kind \
+        ", update cell.hpp and bump RENCPP_CELL_ABI_VERSION" \
+    )
+
+RENCPP_CHECK_KIND(Trash, REB_0);
+RENCPP_CHECK_KIND(Function, REB_FUNCTION);
+RENCPP_CHECK_KIND(Bar, REB_BAR);
+RENCPP_CHECK_KIND(LitBar, REB_LIT_BAR);
+RENCPP_CHECK_KIND(Word, REB_WORD);
+RENCPP_CHECK_KIND(SetWord, REB_SET_WORD);
+RENCPP_CHECK_KIND(GetWord, REB_GET_WORD);
+RENCPP_CHECK_KIND(LitWord, REB_LIT_WORD);
+RENCPP_CHECK_KIND(Refinement, REB_REFINEMENT);
+RENCPP_CHECK_KIND(Issue, REB_ISSUE);
+RENCPP_CHECK_KIND(Path, REB_PATH);
+RENCPP_CHECK_KIND(SetPath, REB_SET_PATH);
+RENCPP_CHECK_KIND(GetPath, REB_GET_PATH);
+RENCPP_CHECK_KIND(LitPath, REB_LIT_PATH);
+RENCPP_CHECK_KIND(Group, REB_GROUP);
+RENCPP_CHECK_KIND(Block, REB_BLOCK);
+RENCPP_CHECK_KIND(Binary, REB_BINARY);
+RENCPP_CHECK_KIND(String, REB_STRING);
+RENCPP_CHECK_KIND(File, REB_FILE);
+RENCPP_CHECK_KIND(Email, REB_EMAIL);
+RENCPP_CHECK_KIND(Url, REB_URL);
+RENCPP_CHECK_KIND(Tag, REB_TAG);
+RENCPP_CHECK_KIND(Bitset, REB_BITSET);
+RENCPP_CHECK_KIND(Image, REB_IMAGE);
+RENCPP_CHECK_KIND(Vector, REB_VECTOR);
+RENCPP_CHECK_KIND(Map, REB_MAP);
+RENCPP_CHECK_KIND(Varargs, REB_VARARGS);
+RENCPP_CHECK_KIND(Object, REB_OBJECT);
+RENCPP_CHECK_KIND(Frame, REB_FRAME);
+RENCPP_CHECK_KIND(Module, REB_MODULE);
+RENCPP_CHECK_KIND(Error, REB_ERROR);
+RENCPP_CHECK_KIND(Port, REB_PORT);
+RENCPP_CHECK_KIND(Logic, REB_LOGIC);
+RENCPP_CHECK_KIND(Integer, REB_INTEGER);
+RENCPP_CHECK_KIND(Decimal, REB_DECIMAL);
+RENCPP_CHECK_KIND(Percent, REB_PERCENT);
+RENCPP_CHECK_KIND(Money, REB_MONEY);
+RENCPP_CHECK_KIND(Char, REB_CHAR);
+RENCPP_CHECK_KIND(Pair, REB_PAIR);
+RENCPP_CHECK_KIND(Tuple, REB_TUPLE);
+RENCPP_CHECK_KIND(Time, REB_TIME);
+RENCPP_CHECK_KIND(Date, REB_DATE);
+RENCPP_CHECK_KIND(Datatype, REB_DATATYPE);
+RENCPP_CHECK_KIND(Typeset, REB_TYPESET);
+RENCPP_CHECK_KIND(Gob, REB_GOB);
+RENCPP_CHECK_KIND(Event, REB_EVENT);
+RENCPP_CHECK_KIND(Handle, REB_HANDLE);
+RENCPP_CHECK_KIND(Struct, REB_STRUCT);
+RENCPP_CHECK_KIND(Library, REB_LIBRARY);
+RENCPP_CHECK_KIND(Blank, REB_BLANK);
+RENCPP_CHECK_KIND(Void, REB_MAX_VOID);
+
+#undef RENCPP_CHECK_KIND
+
+
+static_assert(
+    sizeof(REBVAL) == CellLayout::size,
+    "Cell size doesn't match cell.hpp"
+);
+
+static_assert(
+    offsetof(RELVAL, header) == CellLayout::headerOffset,
+    "Cell header offset doesn't match cell.hpp"
+);
+
+static_assert(
+    offsetof(RELVAL, payload) == CellLayout::payloadOffset,
+    "Cell payload offset doesn't match cell.hpp"
+);
+
+static_assert(
+    VALUE_FLAG_FALSEY == CellLayout::falseyFlag,
+    "VALUE_FLAG_FALSEY doesn't match cell.hpp"
+);
+
+static_assert(
+    sizeof(REBI64) == sizeof(int64_t),
+    "INTEGER! payload isn't 64-bit, update cellInteger() in cell.hpp"
+);
+
+
+#if !defined(NDEBUG)
+
+//
+// The kind byte's position is computed by macros that can't be checked at
+// compile time, so the runtime's own opinion is compared with cell.hpp's
+// once at startup.
+//
+void checkCellLayout() {
+    DECLARE_LOCAL (probe);
+
+    Init_Blank(probe);
+    assert(cellKind(probe) == Kind::Blank);
+    assert(cellIsFalsey(probe));
+
+    Init_Logic(probe, FALSE);
+    assert(cellKind(probe) == Kind::Logic);
+    assert(cellIsFalsey(probe));
+
+    Init_Logic(probe, TRUE);
+    assert(!cellIsFalsey(probe));
+
+    Init_Integer(probe, -1020);
+    assert(cellKind(probe) == Kind::Integer);
+    assert(cellInteger(probe) == -1020);
+
+    Init_Decimal(probe, 10.20);
+    assert(cellKind(probe) == Kind::Decimal);
+    assert(cellDecimal(probe) == 10.20);
+}
+
+#endif
+
+} // end namespace internal
+
+} // end namespace ren
@@ -64,16 +64,6 @@ AnyContext AnyContext::current(Engine * engine) {
 }
 
 
-//
-// TYPE DETECTION
-//
-
-bool AnyContext::isValid(REBVAL const * cell) {
-    return IS_OBJECT(cell);
-}
-
-
-
 //
 // CONSTRUCTION
 //
@@ -1,3 +1,4 @@
+#include <cstring>
 #include <stdexcept>
 
 #include "rencpp/value.hpp"
@@ -9,52 +10,80 @@
 
 namespace ren {
 
-//
-// TYPE DETECTION AND INITIALIZATION
-//
-
-bool Error::isValid(REBVAL const * cell) {
-    return IS_ERROR(cell);
-}
-
-
 
 //
 // CONSTRUCTION
 //
 
 Error::Error (const char * msg, Engine * engine) :
-    AnyContext_ (Dont::Initialize)
+    Error ("message", std::string {msg}, {}, engine)
 {
-    VAL_RESET_HEADER(cell, REB_ERROR);
+}
+
 
+Error::Error (
+    const char * id,
+    std::string const & msg,
+    std::initializer_list<Field> fields,
+    Engine * engine
+) :
+    AnyContext_ (Dont::Initialize)
+{
     if (engine == nullptr)
         engine = &Engine::runFinder();
 
-    std::string array (
-        "#[error! [code: _ type: 'User id: 'message message: "
-    );
+    // This does what MAKE ERROR! does with a spec block, minus having to
+    // have (and scan) the block.  The only way it can fail is if the message
+    // isn't valid UTF-8.
 
-    array += '{';
-    array += msg;
-    array += '}';
+    REBCTX *error;
+    struct Reb_State state;
 
-    // the shim could adjust the where and say what function threw it?
-    // file/line number optional?
+    PUSH_UNHALTABLE_TRAP(&error, &state);
 
-    array += "]]";
+// The first time through the following code 'error' will be NULL, but...
+// `fail` can longjmp here, so 'error' won't be NULL *if* that happens!
 
-    internal::Loadable loadable = array.data();
+    if (error != NULL)
+        throw std::runtime_error("Invalid UTF-8 in ren::Error message");
 
-    constructOrApplyInitialize(
-        engine->getHandle(),
-        nullptr, // no context
-        nullptr, // no applicand
-        &loadable,
-        1,
-        this, // Do construct
-        nullptr // Don't apply
+    REBCTX * context = Copy_Context_Shallow_Extra(
+        VAL_CONTEXT(Get_System(SYS_STANDARD, STD_ERROR)),
+        static_cast<REBCNT>(fields.size())
     );
+    VAL_RESET_HEADER(CTX_VALUE(context), REB_ERROR);
+
+    ERROR_VARS *vars = ERR_VARS(context);
+
+    Init_Word(&vars->type, Canon(SYM_USER));
+    Init_Word(&vars->id, Intern_UTF8_Managed(cb_cast(id), strlen(id)));
+    Init_String(
+        &vars->message,
+        Make_UTF8_May_Fail(
+            cb_cast(msg.data()), static_cast<REBCNT>(msg.size())
+        )
+    );
+
+    for (Field const & field : fields) {
+        REBSTR * name = Intern_UTF8_Managed(
+            cb_cast(field.first), strlen(field.first)
+        );
+
+        // Standard fields (like `where`) are overwritten, not duplicated
+        //
+        REBCNT index = Find_Canon_In_Context(context, STR_CANON(name), FALSE);
+        REBVAL * var = index != 0
+            ? CTX_VAR(context, index)
+            : Append_Context(context, nullptr, name);
+
+        toCell_(var, field.second);
+    }
+
+    Init_Error(cell, context);
+
+    DROP_TRAP_SAME_STACKLEVEL_AS_PUSH(&state);
+
+    finishInit(engine->getHandle());
 }
 
 } // end namespace ren
@@ -20,6 +20,8 @@
 
 #include "rencpp/value.hpp"
 #include "rencpp/function.hpp"
+#include "rencpp/metrics.hpp"
+#include "rencpp/scheduler.hpp"
 
 #include "common.hpp"
 
@@ -30,15 +32,6 @@ namespace internal {
 }
 
 
-//
-// TYPE DETECTION
-//
-
-bool Function::isValid(REBVAL const * cell) {
-    return IS_FUNCTION(cell);
-}
-
-
 // This is the *actual* C function which is poked into the Rebol FUNCTION!,
 // and gets dispatched to when that function is invoked.  The frame parameter
 // contains all of the information about the call, such as the arguments and
@@ -52,6 +45,13 @@ bool Function::isValid(REBVAL const * cell) {
 //
 int32_t Function::Ren_Cpp_Dispatcher(struct Reb_Frame *f)
 {
+    metrics.nativeCalls.add();
+
+    // Calls into C++ are where a ren::Scheduler can let a waiting task run
+    // (on top of this frame, finishing before the call goes on)
+    //
+    Scheduler::atCheckpoint();
+
     REBARR *info = VAL_ARRAY(FUNC_BODY(f->original));
 
     RenEngineHandle engine;
@@ -0,0 +1,321 @@
+//
+// generator.cpp
+// This file is part of RenCpp
+// Copyright (C) 2015-2018 HostileFork.com
+//
+// Licensed under the Boost License, Version 1.0 (the "License")
+//
+//      http://www.boost.org/LICENSE_1_0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.  See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// See http://rencpp.hostilefork.com for more information on this project
+//
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "rencpp/generator.hpp"
+#include "rencpp/error.hpp"
+#include "rencpp/rebol.hpp"
+
+#include "common.hpp"
+
+#if !defined(TO_WINDOWS)
+    #include <pthread.h>
+#endif
+
+
+namespace ren {
+
+namespace {
+
+// The script's thread gets a stack of its own size, rather than whatever
+// the platform gives threads by default (only 512K on macOS).  The runtime
+// is told to report stack overflow a margin before the end of it, leaving
+// room for the natives and C++ code that run past its last check.
+//
+const size_t StackSize = 8 * 1024 * 1024;
+const size_t StackMargin = 256 * 1024;
+
+} // end anonymous namespace
+
+
+
+//
+// HANDING OFF BETWEEN THREADS
+//
+
+//
+// `producerTurn` says which thread may run; the other waits on `changed`.
+// The mutex is only for the handoff itself (and makes what one thread did
+// to the runtime visible to the other).
+//
+// The runtime's C stack limit is for the thread that started it, so it is
+// switched whenever the script's thread takes over and switched back when
+// it hands over.
+//
+
+struct Generator::State {
+    State (Block const & body, size_t batchSize);
+
+    static void * run(void * opaque);
+
+    // False if evaluations begun since the script paused are still running,
+    // or the one it was begun in has returned
+    //
+    bool resumable() const;
+
+    void resume(); // on the C++ side, until the script pauses or finishes
+
+    void pause(); // in YIELD, until C++ wants more
+
+    Function body; // FUNC [yield] with the generator's body
+    Function yield;
+    size_t batchSize;
+
+    std::vector<AnyValue> batch;
+    size_t taken;
+    std::exception_ptr failure;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool producerTurn;
+    bool finished;
+    bool abandoned;
+    bool halting; // cancel() was called from YIELD
+
+#if !defined(TO_WINDOWS)
+    pthread_t thread;
+#endif
+
+    REBUPT producerStackLimit;
+    REBUPT consumerStackLimit;
+
+    // Top of the frame stack when the script paused, which must be the top
+    // again when it resumes
+    //
+    struct Reb_Frame * pausedTop;
+};
+
+
+Generator::State::State (Block const & body, size_t batchSize) :
+    body (static_cast<Function>(
+        *runtime("func [yield [function!]]", body)
+    )),
+    yield (Function::construct(
+        "{Hand a value to the C++ code running this generator}"
+        " value [any-value!]",
+
+        [this](AnyValue const & value) -> optional<AnyValue> {
+            this->batch.push_back(value);
+            if (this->batch.size() >= this->batchSize)
+                pause();
+
+            // The Generator is being destroyed.  A halt can't be caught by
+            // the script, so it will unwind all the way out.
+            //
+            if (abandoned && !halting) {
+                halting = true;
+                runtime.cancel();
+            }
+
+            return nullopt;
+        }
+    )),
+    batchSize (batchSize == 0 ? 1 : batchSize),
+    taken (0),
+    producerTurn (false),
+    finished (false),
+    abandoned (false),
+    halting (false),
+    producerStackLimit (0),
+    consumerStackLimit (0),
+    pausedTop (nullptr)
+{
+}
+
+
+void * Generator::State::run(void * opaque) {
+    State * state = static_cast<State *>(opaque);
+
+    char marker; // near the base of this thread's stack
+
+#if defined(OS_STACK_GROWS_UP)
+    REBUPT limit = reinterpret_cast<REBUPT>(&marker)
+        + (StackSize - StackMargin);
+#else
+    REBUPT limit = reinterpret_cast<REBUPT>(&marker)
+        - (StackSize - StackMargin);
+#endif
+
+    {
+        std::unique_lock<std::mutex> lock {state->mutex};
+        state->changed.wait(lock, [state]() { return state->producerTurn; });
+    }
+
+    state->producerStackLimit = limit;
+    TG_Stack_Limit = limit;
+
+    if (!state->abandoned) {
+        try {
+            state->body(state->yield);
+        }
+        catch (evaluation_halt const &) {
+            if (state->halting)
+                state->halting = false;
+            else
+                state->failure = std::current_exception();
+        }
+        catch (...) {
+            state->failure = std::current_exception();
+        }
+    }
+
+    // If the script finished before it noticed the halt, the halt is still
+    // pending, and would stop whatever C++ evaluates next instead
+
+    if (state->halting) {
+        try {
+            runtime("none");
+        }
+        catch (evaluation_halt const &) {
+        }
+    }
+
+    TG_Stack_Limit = state->consumerStackLimit;
+
+    std::lock_guard<std::mutex> lock {state->mutex};
+    state->finished = true;
+    state->producerTurn = false;
+    state->changed.notify_one();
+    return nullptr;
+}
+
+
+bool Generator::State::resumable() const {
+    return pausedTop == nullptr || FS_TOP == pausedTop;
+}
+
+
+void Generator::State::resume() {
+    if (!resumable())
+        throw std::logic_error(
+            "ren::Generator resumed while evaluations begun after it paused"
+            " are still running (or after the one it began in returned)"
+        );
+
+    consumerStackLimit = TG_Stack_Limit;
+
+    std::unique_lock<std::mutex> lock {mutex};
+    producerTurn = true;
+    changed.notify_one();
+    changed.wait(lock, [this]() { return !producerTurn; });
+}
+
+
+void Generator::State::pause() {
+    pausedTop = FS_TOP;
+    TG_Stack_Limit = consumerStackLimit;
+
+    {
+        std::unique_lock<std::mutex> lock {mutex};
+        producerTurn = false;
+        changed.notify_one();
+        changed.wait(lock, [this]() { return producerTurn; });
+    }
+
+    TG_Stack_Limit = producerStackLimit;
+}
+
+
+
+//
+// GENERATOR
+//
+
+Generator::Generator (Block const & body, size_t batchSize) :
+    state (new State {body, batchSize})
+{
+#if defined(TO_WINDOWS)
+    throw std::runtime_error(
+        "ren::Generator needs POSIX threads, not available on Windows yet"
+    );
+#else
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    pthread_attr_setstacksize(&attributes, StackSize);
+
+    int failure = pthread_create(
+        &state->thread, &attributes, &State::run, state.get()
+    );
+    pthread_attr_destroy(&attributes);
+
+    if (failure != 0)
+        throw std::runtime_error(
+            std::string {"Couldn't start generator thread: "}
+            + strerror(failure)
+        );
+#endif
+}
+
+
+optional<AnyValue> Generator::next() {
+    for (;;) {
+        if (state->taken < state->batch.size())
+            return state->batch[state->taken++];
+
+        if (state->finished) {
+            if (state->failure) {
+                std::exception_ptr failure = state->failure;
+                state->failure = nullptr;
+                std::rethrow_exception(failure);
+            }
+            return nullopt;
+        }
+
+        // The values handed over are released before the script resumes, so
+        // only one batch is alive at a time
+
+        state->batch.clear();
+        state->taken = 0;
+        state->resume();
+    }
+}
+
+
+Generator::~Generator () {
+#if !defined(TO_WINDOWS)
+    state->abandoned = true;
+    while (!state->finished) {
+        // Halting the script means resuming it, which can't be done out of
+        // order, and a destructor mustn't throw.  So the paused script and
+        // its thread are left as they are, for good.
+        //
+        if (!state->resumable()) {
+            fputs(
+                "ren::Generator destroyed out of order, its script leaked\n",
+                stderr
+            );
+            pthread_detach(state->thread);
+            state.release();
+            return;
+        }
+
+        state->batch.clear();
+        state->resume();
+    }
+    pthread_join(state->thread, nullptr);
+#endif
+}
+
+} // end namespace ren
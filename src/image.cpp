@@ -1,3 +1,5 @@
+#include <cstdint>
+#include <cstring>
 #include <stdexcept>
 
 #include "rencpp/value.hpp"
@@ -6,39 +8,454 @@
 
 #include "common.hpp"
 
+#if defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define RENCPP_PIXELS_SSE2 1
+#else
+    #define RENCPP_PIXELS_SSE2 0
+#endif
+
 
 namespace ren {
 
 //
-// IMAGE
+// PIXEL CONVERSION
+//
+
+//
+// Pixels are handled as little-endian 32-bit words, where the byte that is
+// first in memory is the low byte.  In that view the native BGRA order is
+// 0xAARRGGBB, and each of the other orders is one shuffle away from it:
+//
+//     RGBA is 0xAABBGGRR (swap the low and third bytes)
+//     ARGB is 0xBBGGRRAA (reverse all four bytes)
+//
+// Both shuffles are their own inverse, so one routine converts both to and
+// from native.  Premultiplication is done in native order, where the alpha
+// is always the top byte.
+//
+// !!! Big-endian hosts would need the shuffles reversed.
 //
 
-bool Image::isValid(REBVAL const * cell) {
-    return IS_IMAGE(cell);
+namespace {
+
+enum class AlphaOp {
+    None,
+    Premultiply,
+    Unpremultiply
+};
+
+
+inline uint32_t loadPixel(unsigned char const * p) {
+    uint32_t word;
+    memcpy(&word, p, sizeof(word));
+    return word;
 }
 
-#if REN_CLASSLIB_QT == 1
+inline void storePixel(unsigned char * p, uint32_t word) {
+    memcpy(p, &word, sizeof(word));
+}
 
-Image::Image (QImage const & image, Engine * engine) {
-    // need to convert if this isn't true
-    assert(image.format() == QImage::Format_ARGB32);
 
-    REBCNT width = static_cast<REBCNT>(image.width());
-    REBCNT height = static_cast<REBCNT>(image.height());
+template <ChannelOrder Order>
+struct Shuffle;
 
-    VAL_RESET_HEADER(cell, REB_IMAGE);
-    REBSER * img = Make_Image(width, height, FALSE);
+template <>
+struct Shuffle<ChannelOrder::BGRA> {
+    static uint32_t apply(uint32_t x) { return x; }
+
+#if RENCPP_PIXELS_SSE2
+    static __m128i apply(__m128i x) { return x; }
+#endif
+};
+
+template <>
+struct Shuffle<ChannelOrder::RGBA> {
+    static uint32_t apply(uint32_t x) {
+        return (x & 0xFF00FF00u) | ((x >> 16) & 0xFFu) | ((x & 0xFFu) << 16);
+    }
+
+#if RENCPP_PIXELS_SSE2
+    static __m128i apply(__m128i x) {
+        __m128i const keep = _mm_set1_epi32(static_cast<int>(0xFF00FF00u));
+        __m128i const low = _mm_set1_epi32(0xFF);
+
+        return _mm_or_si128(
+            _mm_and_si128(x, keep),
+            _mm_or_si128(
+                _mm_and_si128(_mm_srli_epi32(x, 16), low),
+                _mm_slli_epi32(_mm_and_si128(x, low), 16)
+            )
+        );
+    }
+#endif
+};
+
+template <>
+struct Shuffle<ChannelOrder::ARGB> {
+    static uint32_t apply(uint32_t x) {
+        return (x >> 24) | ((x >> 8) & 0xFF00u)
+            | ((x << 8) & 0xFF0000u) | (x << 24);
+    }
+
+#if RENCPP_PIXELS_SSE2
+    static __m128i apply(__m128i x) {
+        // Swap the bytes of each 16-bit half, then swap the halves
+
+        x = _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+        x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+        return _mm_shufflehi_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+    }
+#endif
+};
+
+
+// Exact rounding of `x / 255` for x in [0, 255 * 255]
+//
+inline uint32_t divide255(uint32_t x) {
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+inline uint32_t premultiply(uint32_t x) {
+    uint32_t a = x >> 24;
+    uint32_t r = divide255(((x >> 16) & 0xFF) * a);
+    uint32_t g = divide255(((x >> 8) & 0xFF) * a);
+    uint32_t b = divide255((x & 0xFF) * a);
+    return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+inline uint32_t unpremultiply(uint32_t x) {
+    uint32_t a = x >> 24;
+    if (a == 0)
+        return 0;
+
+    auto channel = [a](uint32_t c) -> uint32_t {
+        uint32_t result = (c * 255 + a / 2) / a;
+        return result > 255 ? 255 : result;
+    };
+
+    uint32_t r = channel((x >> 16) & 0xFF);
+    uint32_t g = channel((x >> 8) & 0xFF);
+    uint32_t b = channel(x & 0xFF);
+    return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+#if RENCPP_PIXELS_SSE2
+
+inline __m128i premultiply(__m128i x) {
+    __m128i const zero = _mm_setzero_si128();
+    __m128i const round = _mm_set1_epi16(128);
+    __m128i const alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+
+    // Widen to 16 bits per channel, two pixels per register, and spread
+    // each pixel's alpha (lanes 3 and 7) across its four channels.
+
+    __m128i lo = _mm_unpacklo_epi8(x, zero);
+    __m128i hi = _mm_unpackhi_epi8(x, zero);
+
+    __m128i alo = _mm_shufflehi_epi16(
+        _mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)),
+        _MM_SHUFFLE(3, 3, 3, 3)
+    );
+    __m128i ahi = _mm_shufflehi_epi16(
+        _mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)),
+        _MM_SHUFFLE(3, 3, 3, 3)
+    );
+
+    lo = _mm_add_epi16(_mm_mullo_epi16(lo, alo), round);
+    hi = _mm_add_epi16(_mm_mullo_epi16(hi, ahi), round);
+
+    lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+    hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+    // The alpha channel got multiplied by itself along with the others, so
+    // put the original back
+
+    return _mm_or_si128(
+        _mm_andnot_si128(alpha, _mm_packus_epi16(lo, hi)),
+        _mm_and_si128(alpha, x)
+    );
+}
+
+#endif
+
+
+template <AlphaOp Op>
+inline uint32_t applyAlpha(uint32_t x) {
+    return Op == AlphaOp::Premultiply
+        ? premultiply(x)
+        : Op == AlphaOp::Unpremultiply ? unpremultiply(x) : x;
+}
+
+
+template <ChannelOrder From, ChannelOrder To, AlphaOp Op>
+void convertRow(unsigned char const * from, unsigned char * to, size_t width) {
+    size_t x = 0;
+
+#if RENCPP_PIXELS_SSE2
+    if (Op != AlphaOp::Unpremultiply) {
+        for (; x + 4 <= width; x += 4) {
+            __m128i v = _mm_loadu_si128(
+                reinterpret_cast<__m128i const *>(from + x * 4)
+            );
+
+            v = Shuffle<From>::apply(v);
+            if (Op == AlphaOp::Premultiply)
+                v = premultiply(v);
+            v = Shuffle<To>::apply(v);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(to + x * 4), v);
+        }
+    }
+#endif
+
+    for (; x < width; ++x) {
+        uint32_t v = loadPixel(from + x * 4);
+
+        v = Shuffle<From>::apply(v);
+        v = applyAlpha<Op>(v);
+        v = Shuffle<To>::apply(v);
+
+        storePixel(to + x * 4, v);
+    }
+}
+
+
+using RowConverter = void (*)(unsigned char const *, unsigned char *, size_t);
+
+template <ChannelOrder From, ChannelOrder To>
+RowConverter rowConverter(AlphaOp op) {
+    switch (op) {
+    case AlphaOp::Premultiply:
+        return &convertRow<From, To, AlphaOp::Premultiply>;
+
+    case AlphaOp::Unpremultiply:
+        return &convertRow<From, To, AlphaOp::Unpremultiply>;
+
+    case AlphaOp::None:
+    default:
+        return &convertRow<From, To, AlphaOp::None>;
+    }
+}
+
+template <ChannelOrder From>
+RowConverter rowConverter(ChannelOrder to, AlphaOp op) {
+    switch (to) {
+    case ChannelOrder::RGBA:
+        return rowConverter<From, ChannelOrder::RGBA>(op);
 
-    // Was using std::copy, but MSVC complained unless you used a safe
-    // iterator that is non standard.
+    case ChannelOrder::ARGB:
+        return rowConverter<From, ChannelOrder::ARGB>(op);
+
+    case ChannelOrder::BGRA:
+    default:
+        return rowConverter<From, ChannelOrder::BGRA>(op);
+    }
+}
+
+RowConverter rowConverter(ChannelOrder from, ChannelOrder to, AlphaOp op) {
+    switch (from) {
+    case ChannelOrder::RGBA:
+        return rowConverter<ChannelOrder::RGBA>(to, op);
+
+    case ChannelOrder::ARGB:
+        return rowConverter<ChannelOrder::ARGB>(to, op);
+
+    case ChannelOrder::BGRA:
+    default:
+        return rowConverter<ChannelOrder::BGRA>(to, op);
+    }
+}
+
+
+bool overlap(ConstPixelSpan const & from, PixelSpan const & to) {
+    if (from.height == 0 || from.width == 0)
+        return false;
+
+    auto begin = [](unsigned char const * data) {
+        return reinterpret_cast<uintptr_t>(data);
+    };
+    auto end = [&](unsigned char const * data, size_t stride) {
+        return begin(data) + (from.height - 1) * stride + from.width * 4;
+    };
+
+    return begin(from.data) < end(to.data, to.stride)
+        && begin(to.data) < end(from.data, from.stride);
+}
+
+} // end anonymous namespace
+
+
+void convertPixels(ConstPixelSpan const & from, PixelSpan const & to) {
+    if (from.width != to.width || from.height != to.height)
+        throw std::invalid_argument("convertPixels() dimensions differ");
+
+    if (from.stride < from.width * 4 || to.stride < to.width * 4)
+        throw std::invalid_argument("convertPixels() stride less than width");
+
+    // Rows are converted one after another, so a destination overlapping the
+    // source anywhere but exactly on top of it would overwrite pixels before
+    // they were read
     //
-    memcpy(IMG_DATA(img), image.bits(), sizeof(char[4]) * width * height);
+    if (
+        overlap(from, to)
+        && (from.data != to.data || from.stride != to.stride)
+    ){
+        throw std::invalid_argument(
+            "convertPixels() in place needs the same data and stride"
+        );
+    }
+
+    AlphaOp op = AlphaOp::None;
+    if (!from.premultiplied && to.premultiplied)
+        op = AlphaOp::Premultiply;
+    else if (from.premultiplied && !to.premultiplied)
+        op = AlphaOp::Unpremultiply;
+
+    if (op == AlphaOp::None && from.order == to.order) {
+        if (from.data == to.data && from.stride == to.stride)
+            return;
+
+        for (size_t y = 0; y < from.height; ++y)
+            memmove(to.row(y), from.row(y), from.width * 4);
+        return;
+    }
+
+    RowConverter convert = rowConverter(from.order, to.order, op);
+
+    for (size_t y = 0; y < from.height; ++y)
+        convert(from.row(y), to.row(y), from.width);
+}
+
+
+
+//
+// IMAGE
+//
+
+constexpr ChannelOrder Image::nativeOrder;
+
+
+void Image::initFromPixels(ConstPixelSpan const & pixels, Engine * engine) {
+    if (engine == nullptr)
+        engine = &Engine::runFinder();
+
+    REBCNT width = static_cast<REBCNT>(pixels.width);
+    REBCNT height = static_cast<REBCNT>(pixels.height);
+
+    REBSER * img = Make_Image(width, height, FALSE);
+
+    // Convert straight into the series data, no intermediate buffer
+
+    convertPixels(
+        pixels,
+        PixelSpan {
+            IMG_DATA(img),
+            pixels.width,
+            pixels.height,
+            pixels.width * 4,
+            nativeOrder,
+            false
+        }
+    );
 
     Init_Image(cell, img);
     finishInit(engine->getHandle());
 }
 
 
+Image::Image (ConstPixelSpan const & pixels, Engine * engine) :
+    AnyValue (Dont::Initialize)
+{
+    initFromPixels(pixels, engine);
+}
+
+
+size_t Image::width() const {
+    return VAL_IMAGE_WIDE(cell);
+}
+
+
+size_t Image::height() const {
+    return VAL_IMAGE_HIGH(cell);
+}
+
+
+ConstPixelSpan Image::pixels() const {
+    return ConstPixelSpan {
+        VAL_IMAGE_DATA(cell), width(), height(), width() * 4, nativeOrder
+    };
+}
+
+
+PixelSpan Image::pixels() {
+    return PixelSpan {
+        VAL_IMAGE_DATA(cell), width(), height(), width() * 4, nativeOrder
+    };
+}
+
+
+#if REN_CLASSLIB_QT == 1
+
+Image::Image (QImage const & image, Engine * engine) :
+    AnyValue (Dont::Initialize)
+{
+    // QImage's format names describe a native-endian 32-bit word, so its
+    // ARGB32 is BGRA in memory (on little-endian machines).  Formats that
+    // don't have a direct equivalent are converted by Qt first.
+
+    ChannelOrder order;
+    bool premultiplied;
+    QImage converted;
+    QImage const * source = &image;
+
+    switch (image.format()) {
+    case QImage::Format_ARGB32:
+    case QImage::Format_RGB32:
+        order = ChannelOrder::BGRA;
+        premultiplied = false;
+        break;
+
+    case QImage::Format_ARGB32_Premultiplied:
+        order = ChannelOrder::BGRA;
+        premultiplied = true;
+        break;
+
+    case QImage::Format_RGBA8888:
+    case QImage::Format_RGBX8888:
+        order = ChannelOrder::RGBA;
+        premultiplied = false;
+        break;
+
+    case QImage::Format_RGBA8888_Premultiplied:
+        order = ChannelOrder::RGBA;
+        premultiplied = true;
+        break;
+
+    default:
+        converted = image.convertToFormat(QImage::Format_ARGB32);
+        source = &converted;
+        order = ChannelOrder::BGRA;
+        premultiplied = false;
+        break;
+    }
+
+    initFromPixels(
+        ConstPixelSpan {
+            source->constBits(),
+            static_cast<size_t>(source->width()),
+            static_cast<size_t>(source->height()),
+            static_cast<size_t>(source->bytesPerLine()),
+            order,
+            premultiplied
+        },
+        engine
+    );
+}
+
+
 Image::operator QImage () const {
     QImage result {
         VAL_IMAGE_DATA(cell),
@@ -0,0 +1,256 @@
+//
+// marshal.cpp
+// This file is part of RenCpp
+// Copyright (C) 2015-2018 HostileFork.com
+//
+// Licensed under the Boost License, Version 1.0 (the "License")
+//
+//      http://www.boost.org/LICENSE_1_0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.  See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// See http://rencpp.hostilefork.com for more information on this project
+//
+
+#include <cassert>
+#include <stdexcept>
+
+#include "rencpp/marshal.hpp"
+#include "rencpp/engine.hpp"
+#include "rencpp/rebol.hpp"
+
+#include "common.hpp"
+
+
+namespace ren {
+
+namespace internal {
+
+//
+// RECORD LAYOUT
+//
+
+RecordLayout::RecordLayout (char const * const names[], size_t count) :
+    count (count),
+    prototype (),
+    firstIndex (0),
+    cachedKeylist (nullptr)
+{
+    // Build `[field-1: field-2: ... _]` and let the code MAKE OBJECT! uses
+    // collect the keys.  C++ identifiers can't have hyphens, so underscores
+    // in them are taken to stand for hyphens.
+
+    REBARR * spec = Make_Array(static_cast<REBCNT>(count + 1));
+
+    std::string spelling;
+    for (size_t i = 0; i < count; ++i) {
+        spelling = names[i];
+        for (char & c : spelling)
+            if (c == '_')
+                c = '-';
+
+        REBSTR * symbol = Intern_UTF8_Managed(
+            cb_cast(spelling.c_str()), static_cast<REBCNT>(spelling.size())
+        );
+        canons.push_back(STR_CANON(symbol));
+
+        Init_Any_Word(Alloc_Tail_Array(spec), REB_SET_WORD, symbol);
+    }
+    Init_Blank(Alloc_Tail_Array(spec));
+
+    REBCTX * context = Make_Selfish_Context_Detect(
+        REB_OBJECT,
+        ARR_HEAD(spec),
+        nullptr // no parent
+    );
+    Free_Array(spec);
+
+    Init_Object(prototype.cell, context);
+
+    for (REBCNT n = 1; n <= CTX_LEN(context); ++n)
+        Init_Blank(CTX_VAR(context, n));
+
+    // Keys are collected in order (after SELF), so new objects can have
+    // their fields written by stepping through cells from the first one.
+
+    for (size_t i = 0; i < count; ++i) {
+        REBCNT index = Find_Canon_In_Context(
+            context, static_cast<REBSTR *>(canons[i]), FALSE
+        );
+        if (i == 0)
+            firstIndex = index;
+        else if (index != firstIndex + i)
+            throw std::runtime_error("Duplicate field in RENCPP_MARSHAL");
+    }
+
+    cachedKeylist = CTX_KEYLIST(context);
+    cachedIndices.resize(count);
+    for (size_t i = 0; i < count; ++i)
+        cachedIndices[i] = firstIndex + i;
+}
+
+
+
+//
+// WRITING
+//
+
+RenEngineHandle Marshaller::engineHandle(Engine * engine) {
+    return engine ? engine->getHandle() : Engine::runFinder().getHandle();
+}
+
+
+void Marshaller::putInteger(REBVAL * slot, int64_t i) {
+    Init_Integer(slot, i);
+}
+
+
+void Marshaller::putDecimal(REBVAL * slot, double d) {
+    Init_Decimal(slot, d);
+}
+
+
+void Marshaller::putLogic(REBVAL * slot, bool b) {
+    Init_Logic(slot, b ? TRUE : FALSE);
+}
+
+
+void Marshaller::putBlank(REBVAL * slot) {
+    Init_Blank(slot);
+}
+
+
+void Marshaller::putString(REBVAL * slot, std::string const & utf8) {
+
+    // Make_UTF8_May_Fail() will longjmp on invalid UTF-8, and there's no
+    // trap above us when called from plain C++ code.
+
+    REBCTX *error;
+    struct Reb_State state;
+
+    PUSH_UNHALTABLE_TRAP(&error, &state);
+
+// The first time through the following code 'error' will be NULL, but...
+// `fail` can longjmp here, so 'error' won't be NULL *if* that happens!
+
+    if (error != NULL) {
+        Init_Blank(slot);
+        throw std::runtime_error("Invalid UTF-8 in marshalled std::string");
+    }
+
+    Init_String(
+        slot,
+        Make_UTF8_May_Fail(
+            cb_cast(utf8.data()), static_cast<REBCNT>(utf8.size())
+        )
+    );
+
+    DROP_TRAP_SAME_STACKLEVEL_AS_PUSH(&state);
+}
+
+
+REBVAL * Marshaller::putObject(REBVAL * slot, RecordLayout & layout) {
+
+    // The copy shares the prototype's keylist, which is what makes reading
+    // a batch of these back out only need one lookup of the slot indices.
+
+    REBCTX * copy = Copy_Context_Shallow(VAL_CONTEXT(layout.prototype.cell));
+    Init_Object(slot, copy);
+
+    return CTX_VAR(copy, static_cast<REBCNT>(layout.firstIndex));
+}
+
+
+REBVAL * Marshaller::putBlock(REBVAL * slot, size_t count) {
+    REBARR * array = Make_Array(static_cast<REBCNT>(count));
+
+    for (size_t i = 0; i < count; ++i)
+        Init_Blank(Alloc_Tail_Array(array));
+
+    Init_Block(slot, array);
+    return KNOWN(ARR_HEAD(array));
+}
+
+
+
+//
+// READING
+//
+
+void Marshaller::wrongType(REBVAL const * slot, char const * want) {
+    std::string message = "Marshalling expected ";
+    message += want;
+    message += " but got ";
+    message += cs_cast(STR_HEAD(Get_Type_Name(slot)));
+    throw bad_value_cast(message);
+}
+
+
+std::string Marshaller::getString(REBVAL * slot) {
+    if (!ANY_STRING(slot))
+        wrongType(slot, "ANY-STRING!");
+
+    DECLARE_MOLD (mo);
+
+    Push_Mold(mo);
+    Form_Value(mo, slot);
+
+    REBSER * utf8 = Pop_Molded_UTF8(mo);
+    std::string result (cs_cast(SER_HEAD(REBYTE, utf8)), SER_LEN(utf8));
+    Free_Series(utf8);
+
+    return result;
+}
+
+
+void Marshaller::objectSlots(
+    REBVAL * slots[],
+    REBVAL const * object,
+    RecordLayout & layout
+){
+    if (!IS_OBJECT(object))
+        wrongType(object, "OBJECT!");
+
+    REBCTX * context = VAL_CONTEXT(object);
+
+    if (CTX_KEYLIST(context) != layout.cachedKeylist) {
+        for (size_t i = 0; i < layout.count; ++i)
+            layout.cachedIndices[i] = Find_Canon_In_Context(
+                context, static_cast<REBSTR *>(layout.canons[i]), FALSE
+            );
+        layout.cachedKeylist = CTX_KEYLIST(context);
+    }
+
+    for (size_t i = 0; i < layout.count; ++i) {
+        size_t index = layout.cachedIndices[i];
+        slots[i] = index == 0
+            ? nullptr
+            : CTX_VAR(context, static_cast<REBCNT>(index));
+    }
+}
+
+
+size_t Marshaller::arrayLength(REBVAL const * array) {
+    if (!ANY_ARRAY(array))
+        wrongType(array, "ANY-ARRAY!");
+
+    return VAL_LEN_AT(array);
+}
+
+
+REBVAL * Marshaller::arrayHead(REBVAL const * array) {
+    assert(ANY_ARRAY(array));
+
+    // !!! Assumes a specific (not relative) array, which is all RenCpp
+    // hands out at present.
+    //
+    return const_cast<REBVAL *>(KNOWN(VAL_ARRAY_AT(array)));
+}
+
+} // end namespace internal
+
+} // end namespace ren
@@ -0,0 +1,373 @@
+//
+// metrics.cpp
+// This file is part of RenCpp
+// Copyright (C) 2015-2018 HostileFork.com
+//
+// Licensed under the Boost License, Version 1.0 (the "License")
+//
+//      http://www.boost.org/LICENSE_1_0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.  See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// See http://rencpp.hostilefork.com for more information on this project
+//
+
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <locale>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+#include "rencpp/metrics.hpp"
+#include "rencpp/rebol.hpp"
+
+#include "common.hpp"
+
+
+namespace ren {
+
+Metrics metrics;
+
+char const * const Metrics::contentType =
+    "application/openmetrics-text; version=1.0.0; charset=utf-8";
+
+namespace {
+
+//
+// TEXT FORMAT
+//
+
+bool isValidName(std::string const & name) {
+    if (name.empty())
+        return false;
+
+    for (size_t n = 0; n < name.size(); ++n) {
+        char c = name[n];
+        bool letter = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+            || c == '_' || c == ':';
+        bool digit = c >= '0' && c <= '9';
+        if (!letter && !(digit && n != 0))
+            return false;
+    }
+    return true;
+}
+
+
+void writeEscaped(std::ostream & os, std::string const & help) {
+    for (char c : help) {
+        if (c == '\\')
+            os << "\\\\";
+        else if (c == '\n')
+            os << "\\n";
+        else
+            os << c;
+    }
+}
+
+
+// The stream is imbued with the classic locale by the caller, so this gives
+// `0.001` and not `0,001` even if the host program set a locale
+//
+void writeNumber(std::ostream & os, double value) {
+    os << std::setprecision(std::numeric_limits<double>::digits10) << value;
+}
+
+} // end anonymous namespace
+
+
+
+//
+// HISTOGRAM
+//
+
+Histogram::Histogram (std::vector<double> bounds) :
+    bounds (std::move(bounds)),
+    sum (0)
+{
+    for (size_t n = 0; n < this->bounds.size(); ++n) {
+        if (!std::isfinite(this->bounds[n]))
+            throw std::invalid_argument(
+                "Histogram bounds must be finite (+Inf is implicit)"
+            );
+        if (n != 0 && this->bounds[n] <= this->bounds[n - 1])
+            throw std::invalid_argument("Histogram bounds must ascend");
+    }
+
+    size_t size = this->bounds.size() + 1;
+    buckets.reset(new std::atomic<uint64_t>[size]);
+    for (size_t n = 0; n < size; ++n)
+        buckets[n].store(0, std::memory_order_relaxed);
+}
+
+
+void Histogram::observe(double value) {
+    // There are only a handful of bounds, so a linear scan is as quick as a
+    // binary search would be
+
+    size_t n = 0;
+    while (n < bounds.size() && value > bounds[n])
+        ++n;
+    buckets[n].fetch_add(1, std::memory_order_relaxed);
+
+    double old = sum.load(std::memory_order_relaxed);
+    while (!sum.compare_exchange_weak(
+        old, old + value, std::memory_order_relaxed
+    )){
+        continue;
+    }
+}
+
+
+Histogram::Snapshot Histogram::snapshot() const {
+    Snapshot result;
+    result.bounds = bounds;
+
+    // The count is the total of the buckets as they are read, rather than a
+    // counter of its own, so `+Inf` always agrees with `_count`
+
+    uint64_t total = 0;
+    for (size_t n = 0; n <= bounds.size(); ++n) {
+        total += buckets[n].load(std::memory_order_relaxed);
+        result.cumulative.push_back(total);
+    }
+    result.sum = sum.load(std::memory_order_relaxed);
+    return result;
+}
+
+
+
+//
+// REGISTRY
+//
+
+Metrics::Metrics () :
+    applySeconds ({0.00001, 0.0001, 0.001, 0.01, 0.1, 1, 10})
+{
+    add(
+        "ren_evaluations",
+        "Evaluations and applications through RenCpp",
+        Kind::Counter, &evaluations
+    );
+    add(
+        "ren_apply_seconds",
+        "Time taken by evaluations that completed",
+        Kind::Histogram, &applySeconds
+    );
+    add(
+        "ren_scanned_bytes",
+        "Bytes of source text loaded by the scanner",
+        Kind::Counter, &scannedBytes
+    );
+    add(
+        "ren_native_calls",
+        "Calls into C++ through ren::Function",
+        Kind::Counter, &nativeCalls
+    );
+    add(
+        "ren_live_roots",
+        "AnyValue cells held by C++, each a garbage collector root",
+        Kind::Gauge, &liveRoots
+    );
+    add(
+        "ren_output_bytes",
+        "Bytes written to the engine output stream",
+        Kind::Counter, &outputBytes
+    );
+
+    // The runtime counts its collections itself.  The read isn't
+    // synchronized with the evaluator, which at worst renders the count
+    // from just before a collection that is under way.
+    //
+    add(
+        "ren_gc_cycles",
+        "Garbage collections run",
+        Kind::Sampled, nullptr,
+        []() -> uint64_t {
+            if (!PG_Reb_Stats)
+                return 0; // runtime not started yet
+            return static_cast<uint64_t>(PG_Reb_Stats->Recycle_Counter);
+        }
+    );
+}
+
+
+Metrics::Family * Metrics::find(std::string const & name, Kind kind) {
+    for (Family & family : families) {
+        if (family.name != name)
+            continue;
+
+        if (family.kind != kind)
+            throw std::invalid_argument(
+                "Metric " + name + " is registered as another kind"
+            );
+        return &family;
+    }
+    return nullptr;
+}
+
+
+void Metrics::add(
+    std::string const & name,
+    std::string const & help,
+    Kind kind,
+    void * metric,
+    std::function<uint64_t ()> read
+) {
+    if (!isValidName(name))
+        throw std::invalid_argument("Invalid metric name: " + name);
+
+    Family family;
+    family.name = name;
+    family.help = help;
+    family.kind = kind;
+    family.metric = metric;
+    family.read = std::move(read);
+    families.push_back(std::move(family));
+}
+
+
+Counter & Metrics::counter(
+    std::string const & name,
+    std::string const & help
+) {
+    std::lock_guard<std::mutex> lock {mutex};
+
+    if (Family * family = find(name, Kind::Counter))
+        return *static_cast<Counter *>(family->metric);
+
+    counters.emplace_back(new Counter);
+    add(name, help, Kind::Counter, counters.back().get());
+    return *counters.back();
+}
+
+
+Gauge & Metrics::gauge(
+    std::string const & name,
+    std::string const & help
+) {
+    std::lock_guard<std::mutex> lock {mutex};
+
+    if (Family * family = find(name, Kind::Gauge))
+        return *static_cast<Gauge *>(family->metric);
+
+    gauges.emplace_back(new Gauge);
+    add(name, help, Kind::Gauge, gauges.back().get());
+    return *gauges.back();
+}
+
+
+Histogram & Metrics::histogram(
+    std::string const & name,
+    std::string const & help,
+    std::vector<double> bounds
+) {
+    std::lock_guard<std::mutex> lock {mutex};
+
+    if (Family * family = find(name, Kind::Histogram))
+        return *static_cast<Histogram *>(family->metric);
+
+    histograms.emplace_back(new Histogram {std::move(bounds)});
+    add(name, help, Kind::Histogram, histograms.back().get());
+    return *histograms.back();
+}
+
+
+void Metrics::sampledCounter(
+    std::string const & name,
+    std::string const & help,
+    std::function<uint64_t ()> read
+) {
+    std::lock_guard<std::mutex> lock {mutex};
+
+    if (Family * family = find(name, Kind::Sampled)) {
+        family->help = help;
+        family->read = std::move(read);
+        return;
+    }
+
+    add(name, help, Kind::Sampled, nullptr, std::move(read));
+}
+
+
+
+//
+// RENDERING
+//
+
+void Metrics::writeOpenMetrics(std::ostream & os) {
+    std::lock_guard<std::mutex> lock {mutex};
+
+    std::ostringstream out;
+    out.imbue(std::locale::classic());
+
+    for (Family const & family : families) {
+        bool counts = family.kind == Kind::Counter
+            || family.kind == Kind::Sampled;
+
+        out << "# TYPE " << family.name << " "
+            << (counts ? "counter"
+                : family.kind == Kind::Gauge ? "gauge"
+                : "histogram")
+            << "\n";
+
+        out << "# HELP " << family.name << " ";
+        writeEscaped(out, family.help);
+        out << "\n";
+
+        switch (family.kind) {
+        case Kind::Counter:
+            out << family.name << "_total "
+                << static_cast<Counter *>(family.metric)->get() << "\n";
+            break;
+
+        case Kind::Sampled:
+            out << family.name << "_total " << family.read() << "\n";
+            break;
+
+        case Kind::Gauge:
+            out << family.name << " "
+                << static_cast<Gauge *>(family.metric)->get() << "\n";
+            break;
+
+        case Kind::Histogram: {
+            Histogram::Snapshot snapshot
+                = static_cast<Histogram *>(family.metric)->snapshot();
+
+            for (size_t n = 0; n < snapshot.bounds.size(); ++n) {
+                out << family.name << "_bucket{le=\"";
+                writeNumber(out, snapshot.bounds[n]);
+                out << "\"} " << snapshot.cumulative[n] << "\n";
+            }
+            out << family.name << "_bucket{le=\"+Inf\"} "
+                << snapshot.count() << "\n";
+
+            out << family.name << "_count " << snapshot.count() << "\n";
+            out << family.name << "_sum ";
+            writeNumber(out, snapshot.sum);
+            out << "\n";
+            break; }
+
+        default:
+            UNREACHABLE_CODE();
+        }
+    }
+
+    out << "# EOF\n";
+
+    os << out.str();
+}
+
+
+std::string Metrics::openMetrics() {
+    std::ostringstream os;
+    writeOpenMetrics(os);
+    return os.str();
+}
+
+} // end namespace ren
@@ -0,0 +1,289 @@
+//
+// mold.cpp
+// This file is part of RenCpp
+// Copyright (C) 2015-2018 HostileFork.com
+//
+// Licensed under the Boost License, Version 1.0 (the "License")
+//
+//      http://www.boost.org/LICENSE_1_0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.  See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// See http://rencpp.hostilefork.com for more information on this project
+//
+
+#include <algorithm>
+#include <vector>
+
+#include "rencpp/mold.hpp"
+#include "rencpp/error.hpp"
+#include "rencpp/rebol.hpp"
+
+#include "common.hpp"
+
+
+namespace ren {
+
+namespace internal {
+
+//
+// MOLDER
+//
+
+//
+// MOLD itself can't be stopped partway, so the Molder does the walk over
+// blocks and groups, and only hands the items that aren't arrays to
+// Mold_Value().  Everything goes into the one mold buffer, whose length is
+// checked between items.
+//
+
+class Molder {
+public:
+    static Molded run(
+        AnyValue const & value,
+        bool range,
+        size_t offset,
+        size_t count,
+        MoldLimits const & limits
+    );
+
+private:
+    Molder (
+        MoldLimits const & limits,
+        REB_MOLD * mo,
+        std::vector<REBARR *> & stack
+    ) :
+        limits (limits),
+        mo (mo),
+        stack (stack),
+        elements (0),
+        truncated (false),
+        stopped (false)
+    {
+    }
+
+    // The buffer holds codepoints, each of which is at least one byte of
+    // UTF-8, so once this passes maxBytes the UTF-8 will be cut.
+    //
+    REBCNT bufferLength() const {
+        return SER_LEN(mo->series) - mo->start;
+    }
+
+    void appendEllipsis() {
+        Append_Unencoded(mo->series, limits.ellipsis);
+        truncated = true;
+    }
+
+    void moldItem(RELVAL const * item, size_t depth);
+
+    void moldItems(REBARR * array, REBCNT index, REBCNT end, size_t depth);
+
+    MoldLimits const & limits;
+    REB_MOLD * mo;
+    std::vector<REBARR *> & stack; // arrays being molded, to catch cycles
+    size_t elements;
+    bool truncated; // something was left out, or shown as `...`
+    bool stopped; // the byte or element limit was hit, so mold no more
+};
+
+
+void Molder::moldItem(RELVAL const * item, size_t depth) {
+    ++elements;
+
+    if (IS_BLOCK(item) || IS_GROUP(item)) {
+        bool block = IS_BLOCK(item);
+        REBARR * array = VAL_ARRAY(item);
+
+        Append_Unencoded(mo->series, block ? "[" : "(");
+
+        if (limits.maxDepth != 0 && depth >= limits.maxDepth)
+            appendEllipsis();
+        else if (
+            std::find(stack.begin(), stack.end(), array) != stack.end()
+        ){
+            // Same as MOLD does for a block that contains itself
+            //
+            Append_Unencoded(mo->series, "...");
+        }
+        else {
+            stack.push_back(array);
+            moldItems(array, VAL_INDEX(item), ARR_LEN(array), depth + 1);
+            stack.pop_back();
+        }
+
+        Append_Unencoded(mo->series, block ? "]" : ")");
+        return;
+    }
+
+    if (
+        (ANY_STRING(item) || IS_BINARY(item))
+        && limits.maxBytes != 0
+        && VAL_LEN_AT(item) > limits.maxBytes
+    ){
+        // Only a prefix of the data can fit, so don't mold the rest.  The
+        // prefix's mold is longer than maxBytes, so it will get cut.
+        //
+        REBSER * part = Copy_Sequence_At_Len(
+            VAL_SERIES(item),
+            VAL_INDEX(item),
+            static_cast<REBCNT>(limits.maxBytes)
+        );
+        MANAGE_SERIES(part);
+
+        DECLARE_LOCAL (prefix);
+        Init_Any_Series(prefix, VAL_TYPE(item), part);
+        Mold_Value(mo, prefix);
+
+        truncated = true;
+        stopped = true;
+        return;
+    }
+
+    Mold_Value(mo, item);
+}
+
+
+void Molder::moldItems(
+    REBARR * array,
+    REBCNT index,
+    REBCNT end,
+    size_t depth
+) {
+    for (REBCNT n = index; n < end; ++n) {
+        if (stopped)
+            return; // a limit was hit inside a nested array
+
+        if (limits.maxBytes != 0 && bufferLength() > limits.maxBytes) {
+            truncated = true;
+            stopped = true;
+            return;
+        }
+
+        if (n != index)
+            Append_Unencoded(mo->series, " ");
+
+        if (limits.maxElements != 0 && elements >= limits.maxElements) {
+            appendEllipsis();
+            stopped = true;
+            return;
+        }
+
+        // !!! Assumes a specific (not relative) array, which is all RenCpp
+        // hands out at present.
+        //
+        moldItem(ARR_AT(array, n), depth);
+    }
+}
+
+
+Molded Molder::run(
+    AnyValue const & value,
+    bool range,
+    size_t offset,
+    size_t count,
+    MoldLimits const & limits
+) {
+    // Allocated out here so the `fail` path (a longjmp) only skips frames
+    // which have nothing to destruct.
+
+    std::vector<REBARR *> stack;
+
+    REBSER * utf8;
+    bool truncated;
+
+    REBCTX * error;
+    struct Reb_State state;
+
+    PUSH_UNHALTABLE_TRAP(&error, &state);
+
+// The first time through the following code 'error' will be NULL, but...
+// `fail` can longjmp here, so 'error' won't be NULL *if* that happens!
+
+    if (error) {
+        AnyValue errorValue;
+        Init_Error(errorValue.cell, error);
+        throw evaluation_error {static_cast<Error>(errorValue)};
+    }
+
+    {
+        DECLARE_MOLD (mo);
+        Push_Mold(mo);
+
+        if (limits.all)
+            SET_MOLD_FLAG(mo, MOLD_FLAG_ALL);
+
+        Molder molder {limits, mo, stack};
+
+        if (range) {
+            REBARR * array = VAL_ARRAY(value.cell);
+            REBCNT len = ARR_LEN(array);
+
+            REBCNT start = static_cast<REBCNT>(std::min<size_t>(
+                VAL_INDEX(value.cell) + offset, len
+            ));
+            REBCNT end = static_cast<REBCNT>(std::min<size_t>(
+                start + count, len
+            ));
+
+            stack.push_back(array);
+            molder.moldItems(array, start, end, 1);
+        }
+        else
+            molder.moldItem(value.cell, 0);
+
+        truncated = molder.truncated;
+        utf8 = Pop_Molded_UTF8(mo);
+    }
+
+    DROP_TRAP_SAME_STACKLEVEL_AS_PUSH(&state);
+
+    Molded result;
+    result.text.assign(cs_cast(SER_HEAD(REBYTE, utf8)), SER_LEN(utf8));
+    result.truncated = truncated;
+
+    Free_Series(utf8);
+
+    if (limits.maxBytes != 0 && result.text.size() > limits.maxBytes) {
+        //
+        // Back up to the start of a UTF-8 sequence, so the cut doesn't leave
+        // part of a character behind
+        //
+        size_t cut = limits.maxBytes;
+        while (cut > 0 && (result.text[cut] & 0xC0) == 0x80)
+            --cut;
+
+        result.text.resize(cut);
+        result.text += limits.ellipsis;
+        result.truncated = true;
+    }
+
+    return result;
+}
+
+} // end namespace internal
+
+
+
+//
+// MOLD
+//
+
+Molded mold(AnyValue const & value, MoldLimits const & limits) {
+    return internal::Molder::run(value, false, 0, 0, limits);
+}
+
+
+Molded moldRange(
+    AnyArray const & array,
+    size_t offset,
+    size_t count,
+    MoldLimits const & limits
+) {
+    return internal::Molder::run(array, true, offset, count, limits);
+}
+
+} // end namespace ren
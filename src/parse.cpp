@@ -0,0 +1,254 @@
+//
+// parse.cpp
+// This file is part of RenCpp
+// Copyright (C) 2015-2018 HostileFork.com
+//
+// Licensed under the Boost License, Version 1.0 (the "License")
+//
+//      http://www.boost.org/LICENSE_1_0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.  See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// See http://rencpp.hostilefork.com for more information on this project
+//
+
+#include <cassert>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "rencpp/parse.hpp"
+#include "rencpp/words.hpp"
+#include "rencpp/context.hpp"
+#include "rencpp/function.hpp"
+#include "rencpp/error.hpp"
+#include "rencpp/rebol.hpp"
+
+#include "common.hpp"
+
+
+namespace ren {
+
+namespace {
+
+//
+// RULE RESOLUTION
+//
+
+// Words that PARSE dispatches on by spelling, regardless of binding
+
+REBSYM const keywords[] = {
+    SYM_SET, SYM_COPY, SYM_ANY, SYM_SOME, SYM_OPT, SYM_NOT, SYM_THEN,
+    SYM_REMOVE, SYM_INSERT, SYM_CHANGE, SYM_IF, SYM_FAIL, SYM_REJECT,
+    SYM_WHILE, SYM_RETURN, SYM_LIMIT, SYM_QQ, SYM_ACCEPT, SYM_BREAK,
+    SYM_SKIP, SYM_TO, SYM_THRU, SYM_QUOTE, SYM_DO, SYM_INTO, SYM_ONLY,
+    SYM_END, SYM_AND, SYM_AHEAD, SYM_MARK, SYM_SEEK
+};
+
+bool isKeyword(REBSYM sym) {
+    for (REBSYM keyword : keywords)
+        if (sym == keyword)
+            return true;
+    return false;
+}
+
+
+// Keyed on array and index, as two BLOCK!s at different positions in the same
+// array are different rules.
+//
+using Resolved = std::map<std::pair<REBARR *, REBCNT>, REBARR *>;
+
+REBARR * resolveRule(REBARR * array, REBCNT index, Resolved & resolved);
+
+
+void resolveItems(REBARR * copy, Resolved & resolved) {
+    // The next item is a SET, COPY, MARK or SEEK target, or a QUOTE argument
+    //
+    bool literal = false;
+
+    RELVAL * item = ARR_HEAD(copy);
+    for (; NOT_END(item); ++item) {
+        if (literal) {
+            literal = false;
+            continue;
+        }
+
+        if (IS_BLOCK(item)) {
+            Init_Block(
+                item,
+                resolveRule(VAL_ARRAY(item), VAL_INDEX(item), resolved)
+            );
+            continue;
+        }
+
+        if (!IS_WORD(item))
+            continue;
+
+        REBSYM sym = VAL_WORD_SYM(item);
+        if (isKeyword(sym)) {
+            literal = (
+                sym == SYM_SET || sym == SYM_COPY || sym == SYM_QUOTE
+                || sym == SYM_MARK || sym == SYM_SEEK
+            );
+            continue;
+        }
+
+        if (IS_WORD_UNBOUND(item))
+            fail (Error_Not_Bound_Raw(item));
+
+        // Blocks coming from C++ are always fully specified
+        //
+        const REBVAL * var = Get_Opt_Var_May_Fail(item, SPECIFIED);
+
+        if (IS_BLOCK(var))
+            Init_Block(
+                item,
+                resolveRule(VAL_ARRAY(var), VAL_INDEX(var), resolved)
+            );
+        else if (
+            IS_BITSET(var) || IS_CHAR(var) || ANY_STRING(var)
+            || IS_BINARY(var)
+        ) {
+            Move_Value(item, var);
+        }
+    }
+}
+
+
+REBARR * resolveRule(REBARR * array, REBCNT index, Resolved & resolved) {
+    auto key = std::make_pair(array, index);
+
+    auto it = resolved.find(key);
+    if (it != resolved.end())
+        return it->second;
+
+    // Nested blocks are resolved through their own entries, so a shallow
+    // copy is enough.  It's recorded before resolving its items so that a
+    // rule which refers back to itself finds it.
+    //
+    REBARR * copy = Copy_Array_At_Shallow(array, index, SPECIFIED);
+    MANAGE_ARRAY(copy);
+    resolved[key] = copy;
+
+    resolveItems(copy, resolved);
+    return copy;
+}
+
+} // end anonymous namespace
+
+
+
+//
+// PARSE RULE
+//
+
+ParseRule::ParseRule (Block const & rule) :
+    compiled (rule),
+    parser ()
+{
+    // Allocating the map out here means the `fail` path (a longjmp) only
+    // skips frames which have nothing to destruct.
+
+    Resolved resolved;
+
+    REBCTX * error;
+    struct Reb_State state;
+
+    PUSH_UNHALTABLE_TRAP(&error, &state);
+
+// The first time through the following code 'error' will be NULL, but...
+// `fail` can longjmp here, so 'error' won't be NULL *if* that happens!
+
+    if (error) {
+        AnyValue errorValue;
+        Init_Error(errorValue.cell, error);
+        throw evaluation_error {static_cast<Error>(errorValue)};
+    }
+
+    REBARR * root = resolveRule(
+        VAL_ARRAY(rule.cell), VAL_INDEX(rule.cell), resolved
+    );
+    Init_Block(compiled.cell, root);
+
+    REBCNT n = Find_Canon_In_Context(Lib_Context, Canon(SYM_PARSE), TRUE);
+    assert(n != 0);
+    Move_Value(parser.cell, CTX_VAR(Lib_Context, n));
+
+    DROP_TRAP_SAME_STACKLEVEL_AS_PUSH(&state);
+}
+
+
+optional<AnyValue> ParseRule::operator()(AnySeries const & input) const {
+    return parser.apply(input, compiled);
+}
+
+
+
+//
+// C++ ACTIONS
+//
+
+Block ParseRule::action(AnyValue const & rule, Callback const & callback) {
+
+    // This is `start: rule end: (callback :start :end)`, except that the
+    // start is pushed onto a stack when it's marked.  The sub-rule might use
+    // this same action again, and that inner match would overwrite a shared
+    // `start:` before the outer one finished.  If the sub-rule fails, the
+    // start it pushed is dropped, and the match fails as it would have.
+    //
+    // The mark itself is in an object of its own, so no variable of the
+    // caller's gets set.  It's only a position in the input, so nothing is
+    // copied.
+
+    Object marks {"mark: _"};
+
+    std::shared_ptr<std::vector<AnySeries>> starts
+        = std::make_shared<std::vector<AnySeries>>();
+
+    // The lambdas return a value instead of void because
+    // Function::construct keeps only a reference to void-returning callables.
+    //
+    Function begin = Function::construct(
+        "{Mark start of C++ PARSE action} start [any-series!]",
+        [starts](AnySeries const & start) -> optional<AnyValue> {
+            starts->push_back(start);
+            return nullopt;
+        }
+    );
+
+    Function finish = Function::construct(
+        "{Run C++ PARSE action} end [any-series!]",
+        [starts, callback](AnySeries const & end) -> optional<AnyValue> {
+            AnySeries start = starts->back();
+            starts->pop_back();
+            callback(start, start.index(), end.index());
+            return nullopt;
+        }
+    );
+
+    Function drop = Function::construct(
+        "{Forget start of failed C++ PARSE action}",
+        [starts]() -> optional<AnyValue> {
+            starts->pop_back();
+            return nullopt;
+        }
+    );
+
+    return Block {
+        SetWord {"mark", marks},
+        Group {begin, GetWord {"mark", marks}},
+        rule,
+        SetWord {"mark", marks},
+        Group {finish, GetWord {"mark", marks}},
+        "|",
+        Group {drop},
+        "fail"
+    };
+}
+
+} // end namespace ren
@@ -0,0 +1,490 @@
+//
+// process.cpp
+// This file is part of RenCpp
+// Copyright (C) 2015-2018 HostileFork.com
+//
+// Licensed under the Boost License, Version 1.0 (the "License")
+//
+//      http://www.boost.org/LICENSE_1_0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.  See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// See http://rencpp.hostilefork.com for more information on this project
+//
+
+#include <cerrno>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+
+#include "rencpp/process.hpp"
+#include "rencpp/arrays.hpp"
+#include "rencpp/engine.hpp"
+#include "rencpp/error.hpp"
+#include "rencpp/metrics.hpp"
+#include "rencpp/rebol.hpp"
+
+#include "common.hpp"
+
+#if !defined(TO_WINDOWS)
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <pthread.h>
+    #include <signal.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+#endif
+
+
+namespace ren {
+
+namespace {
+
+#if !defined(TO_WINDOWS)
+
+//
+// PIPES
+//
+
+void closeIfOpen(int & fd) {
+    if (fd != -1) {
+        close(fd);
+        fd = -1;
+    }
+}
+
+
+void makePipe(int fds[2]) {
+    if (pipe(fds) != 0)
+        throw std::runtime_error(
+            std::string {"Couldn't make a pipe: "} + strerror(errno)
+        );
+
+    // None of the parent's ends should leak into the child (or into any
+    // other process the parent starts from another thread)
+    //
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+}
+
+
+//
+// RUNNING CHILD
+//
+
+//
+// Owns the parent's ends of the pipes and the child's pid, so that if the
+// callback throws (or anything else does) the child is killed and reaped
+// instead of being left running.
+//
+
+struct Child {
+    pid_t pid;
+    int input;
+    int output;
+    int error;
+
+    Child () : pid (-1), input (-1), output (-1), error (-1) {}
+
+    int wait() {
+        int status;
+        while (waitpid(pid, &status, 0) == -1)
+            if (errno != EINTR)
+                throw std::runtime_error(
+                    std::string {"waitpid() failed: "} + strerror(errno)
+                );
+        pid = -1;
+
+        if (WIFSIGNALED(status))
+            return 128 + WTERMSIG(status);
+        return WEXITSTATUS(status);
+    }
+
+    ~Child () {
+        closeIfOpen(input);
+        closeIfOpen(output);
+        closeIfOpen(error);
+
+        if (pid != -1) {
+            kill(pid, SIGKILL);
+            int status;
+            while (waitpid(pid, &status, 0) == -1 && errno == EINTR)
+                continue;
+        }
+    }
+};
+
+
+//
+// WRITING INPUT
+//
+
+//
+// Writing to a pipe whose reader has exited raises SIGPIPE, which would
+// kill the whole program.  It's blocked on this thread while writing, and
+// if one was raised it is taken out of the pending set before unblocking.
+//
+
+class SigpipeBlock {
+    sigset_t pipeSet;
+    sigset_t previous;
+
+public:
+    SigpipeBlock () {
+        sigemptyset(&pipeSet);
+        sigaddset(&pipeSet, SIGPIPE);
+        pthread_sigmask(SIG_BLOCK, &pipeSet, &previous);
+    }
+
+    ~SigpipeBlock () {
+        sigset_t pending;
+        sigpending(&pending);
+        bool raised = sigismember(&pending, SIGPIPE) != 0;
+        if (raised && !sigismember(&previous, SIGPIPE)) {
+            int signum;
+            sigwait(&pipeSet, &signum);
+        }
+        pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+    }
+};
+
+#endif // !defined(TO_WINDOWS)
+
+
+
+//
+// APPENDING TO SERIES
+//
+
+//
+// A chunk of output can end in the middle of a UTF-8 sequence, so for a
+// STRING! only up to the last whole character is decoded and the rest is
+// held over for the next chunk.
+//
+
+size_t wholeUtf8Prefix(char const * data, size_t size) {
+    size_t start = size;
+    size_t back = 0;
+    while (start > 0 && back < 4) {
+        --start;
+        ++back;
+        unsigned char byte = static_cast<unsigned char>(data[start]);
+        if ((byte & 0xC0) == 0x80)
+            continue; // continuation byte, keep looking for the lead
+
+        size_t needed = byte < 0x80 ? 1
+            : byte >= 0xF0 ? 4
+            : byte >= 0xE0 ? 3
+            : 2;
+        return needed <= back ? size : start;
+    }
+    return size; // not UTF-8 anyway; let the decoder complain
+}
+
+} // end anonymous namespace
+
+
+
+//
+// RUN
+//
+
+int Subprocess::run(
+    std::vector<std::string> const & arguments,
+    Callback const & callback,
+    std::string const & input
+) {
+#if defined(TO_WINDOWS)
+    UNUSED(arguments);
+    UNUSED(callback);
+    UNUSED(input);
+    throw std::runtime_error(
+        "ren::Subprocess needs fork(), which is not available on Windows"
+    );
+#else
+    if (arguments.empty())
+        throw std::runtime_error("ren::Subprocess needs a program to run");
+
+    // Everything the child needs is made before fork(), as between fork()
+    // and exec() only async-signal-safe calls are allowed.
+
+    std::vector<char *> argv;
+    for (auto const & argument : arguments)
+        argv.push_back(const_cast<char *>(argument.c_str()));
+    argv.push_back(nullptr);
+
+    int inputPipe[2];
+    int outputPipe[2];
+    int errorPipe[2];
+    int execPipe[2]; // gets errno if exec fails, closes on success
+
+    makePipe(inputPipe);
+    makePipe(outputPipe);
+    makePipe(errorPipe);
+    makePipe(execPipe);
+
+    Child child;
+    child.input = inputPipe[1];
+    child.output = outputPipe[0];
+    child.error = errorPipe[0];
+
+    child.pid = fork();
+    if (child.pid == 0) {
+        dup2(inputPipe[0], STDIN_FILENO);
+        dup2(outputPipe[1], STDOUT_FILENO);
+        dup2(errorPipe[1], STDERR_FILENO);
+
+        execvp(argv[0], argv.data());
+
+        int failure = errno;
+        ssize_t ignored = write(execPipe[1], &failure, sizeof(failure));
+        UNUSED(ignored);
+        _exit(127);
+    }
+
+    int forkFailure = errno;
+
+    close(inputPipe[0]);
+    close(outputPipe[1]);
+    close(errorPipe[1]);
+    close(execPipe[1]);
+
+    if (child.pid == -1) {
+        close(execPipe[0]);
+        throw std::runtime_error(
+            std::string {"Couldn't fork(): "} + strerror(forkFailure)
+        );
+    }
+
+    int execFailure;
+    ssize_t got;
+    while (
+        (got = read(execPipe[0], &execFailure, sizeof(execFailure))) == -1
+        && errno == EINTR
+    ){
+        continue;
+    }
+    close(execPipe[0]);
+
+    if (got == sizeof(execFailure)) {
+        child.wait();
+        throw std::runtime_error(
+            "Couldn't run " + arguments[0] + ": " + strerror(execFailure)
+        );
+    }
+
+    // Input is written as the pipe has room for it, between reads of the
+    // output.  (Writing it all first would deadlock with a child that is
+    // blocked writing output no one is reading yet.)
+
+    size_t written = 0;
+    if (input.empty())
+        closeIfOpen(child.input);
+    else
+        fcntl(
+            child.input, F_SETFL, fcntl(child.input, F_GETFL) | O_NONBLOCK
+        );
+
+    SigpipeBlock sigpipeBlock;
+
+    char buffer[65536];
+
+    while (child.output != -1 || child.error != -1) {
+        // A closed fd is -1, which poll() ignores, so the indices stay put
+
+        pollfd fds[3];
+        fds[0].fd = child.output;
+        fds[0].events = POLLIN;
+        fds[1].fd = child.error;
+        fds[1].events = POLLIN;
+        fds[2].fd = child.input;
+        fds[2].events = POLLOUT;
+
+        if (poll(fds, 3, -1) == -1) {
+            if (errno == EINTR)
+                continue;
+            throw std::runtime_error(
+                std::string {"poll() failed: "} + strerror(errno)
+            );
+        }
+
+        for (int n = 0; n < 2; ++n) {
+            if (fds[n].revents == 0)
+                continue;
+
+            int & fd = (n == 0) ? child.output : child.error;
+            ssize_t size = read(fd, buffer, sizeof(buffer));
+            if (size > 0)
+                callback(
+                    n == 0 ? Channel::Output : Channel::Error,
+                    buffer,
+                    static_cast<size_t>(size)
+                );
+            else if (size == 0 || errno != EINTR)
+                closeIfOpen(fd); // end of output, or an error reading it
+        }
+
+        if (fds[2].revents != 0) {
+            ssize_t size = write(
+                child.input, input.data() + written, input.size() - written
+            );
+            if (size > 0)
+                written += static_cast<size_t>(size);
+
+            bool failed = size == -1 && errno != EAGAIN && errno != EINTR;
+            if (failed || written == input.size())
+                closeIfOpen(child.input); // done, or the child stopped reading
+        }
+    }
+
+    closeIfOpen(child.input);
+    return child.wait();
+#endif
+}
+
+
+Subprocess::Captured Subprocess::capture(
+    std::vector<std::string> const & arguments,
+    std::string const & input
+) {
+    Captured result;
+    result.status = run(
+        arguments,
+        [&result](Channel channel, char const * data, size_t size) {
+            if (channel == Channel::Output)
+                result.output.append(data, size);
+            else
+                result.error.append(data, size);
+        },
+        input
+    );
+    return result;
+}
+
+
+
+//
+// SCRIPT FUNCTION
+//
+
+// Only PODs in here, as `fail` can longjmp out of the middle of it
+//
+void Subprocess::appendChunk(
+    REBVAL * target,
+    char const * data,
+    size_t size
+) {
+    REBCTX * error;
+    struct Reb_State state;
+
+    PUSH_UNHALTABLE_TRAP(&error, &state);
+
+// The first time through the following code 'error' will be NULL, but...
+// `fail` can longjmp here, so 'error' won't be NULL *if* that happens!
+
+    if (error) {
+        AnyValue errorValue;
+        Init_Error(errorValue.cell, error);
+        throw evaluation_error {static_cast<Error>(errorValue)};
+    }
+
+    REBSER * series = VAL_SERIES(target);
+    FAIL_IF_READ_ONLY_SERIES(series);
+
+    if (IS_BINARY(target))
+        Append_Series(series, cb_cast(data), static_cast<REBCNT>(size));
+    else
+        Append_UTF8_May_Fail(series, cb_cast(data), static_cast<REBCNT>(size));
+
+    DROP_TRAP_SAME_STACKLEVEL_AS_PUSH(&state);
+}
+
+
+Function Subprocess::function() {
+    return Function::construct(
+        "{Run a program (not through a shell) and return its exit status}"
+        " command [block!] {Program and arguments, FORMed, e.g. [ls -l %.]}"
+        " /input {Write to its standard input, then close it}"
+        " in [string! binary!]"
+        " /output {Append its standard output here as it arrives}"
+        " out [string! binary!]"
+        " /error {Append its standard error here as it arrives}"
+        " err [string! binary!]",
+
+        [](
+            Block const & command,
+            AnyValue const &, optional<AnyValue> const & in,
+            AnyValue const &, optional<AnyValue> const & out,
+            AnyValue const &, optional<AnyValue> const & err
+        )
+            -> optional<AnyValue>
+        {
+            std::vector<std::string> arguments;
+            for (auto item : command)
+                arguments.push_back(to_string(item));
+
+            // A BINARY! is written as its bytes, not FORMed as `#{...}`
+            //
+            std::string input;
+            if (in && internal::cellKind(in->cell) == Kind::Binary) {
+                REBVAL const * bytes = in->cell;
+                input.assign(
+                    cs_cast(BIN_AT(VAL_SERIES(bytes), VAL_INDEX(bytes))),
+                    VAL_LEN_AT(bytes)
+                );
+            }
+            else if (in)
+                input = to_string(*in);
+
+            // Partial UTF-8 sequences held over for a STRING! target
+
+            std::string pending[2];
+
+            std::ostream & os = Engine::runFinder().getOutputStream();
+
+            int status = run(
+                arguments,
+                [&](Channel channel, char const * data, size_t size) {
+                    int n = channel == Channel::Output ? 0 : 1;
+                    optional<AnyValue> const & target = n == 0 ? out : err;
+
+                    if (!target) {
+                        os.write(data, static_cast<std::streamsize>(size));
+                        os.flush();
+                        metrics.outputBytes.add(size);
+                        return;
+                    }
+
+                    if (internal::cellKind(target->cell) == Kind::Binary) {
+                        appendChunk(target->cell, data, size);
+                        return;
+                    }
+
+                    std::string & held = pending[n];
+                    held.append(data, size);
+
+                    size_t whole = wholeUtf8Prefix(held.data(), held.size());
+                    appendChunk(target->cell, held.data(), whole);
+                    held.erase(0, whole);
+                },
+                input
+            );
+
+            // A sequence still cut off at the end is passed on as it is, so
+            // the decoder reports it
+
+            if (out && !pending[0].empty())
+                appendChunk(out->cell, pending[0].data(), pending[0].size());
+            if (err && !pending[1].empty())
+                appendChunk(err->cell, pending[1].data(), pending[1].size());
+
+            return Integer {status};
+        }
+    );
+}
+
+} // end namespace ren
@@ -0,0 +1,395 @@
+//
+// profiler.cpp
+// This file is part of RenCpp
+// Copyright (C) 2015-2018 HostileFork.com
+//
+// Licensed under the Boost License, Version 1.0 (the "License")
+//
+//      http://www.boost.org/LICENSE_1_0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.  See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// See http://rencpp.hostilefork.com for more information on this project
+//
+
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+#include "rencpp/profiler.hpp"
+#include "rencpp/function.hpp"
+#include "rencpp/rebol.hpp"
+
+#include "common.hpp"
+
+#if !defined(TO_WINDOWS)
+    #include <pthread.h>
+    #include <signal.h>
+    #include <sys/time.h>
+#endif
+
+
+namespace ren {
+
+Profiler profiler;
+
+namespace {
+
+//
+// SAMPLE BUFFER
+//
+
+//
+// The signal handler is the single producer and drain() is the single
+// consumer, so a ring with two monotonic counters is enough.  The buffer is
+// statically allocated so the handler never touches the heap.
+//
+// Labels are copied out as text by the handler.  Keeping the REBSTR* to
+// look up later would mean trusting that the symbol outlives the sample,
+// which a GC between the sample and drain() can break.
+//
+
+const size_t MaxDepth = 64;
+const size_t Capacity = 1024;
+const size_t LabelSize = 32; // longer spellings are cut short
+
+struct SampledFrame {
+    char label[LabelSize]; // empty if the function had no label
+    bool cpp; // implemented with ren::Function
+};
+
+struct Sample {
+    size_t depth; // number of entries in `frames`
+    bool truncated; // stack was deeper than MaxDepth, or couldn't be walked
+    bool collecting; // the garbage collector was running
+    SampledFrame frames[MaxDepth]; // leaf first
+};
+
+Sample samples[Capacity];
+
+std::atomic<size_t> produced {0};
+std::atomic<size_t> consumed {0};
+std::atomic<size_t> dropped {0};
+
+std::atomic<bool> running {false};
+
+// Dispatcher of FUNCTION!s made by ren::Function::construct(), captured by
+// start() (which is a friend of Function) so the handler can recognize them
+//
+REBNAT cppDispatcher = nullptr;
+
+// Aggregated stacks, keyed by the folded "root;...;leaf" string.  Only
+// touched by the consumer side, under this mutex.
+//
+std::mutex foldedMutex;
+std::map<std::string, size_t> foldedCounts;
+size_t totalSamples = 0;
+
+#if !defined(TO_WINDOWS)
+    pthread_t target;
+    uintptr_t stackTop; // highest address of the target thread's stack
+    struct sigaction previousAction;
+#endif
+
+
+//
+// SIGNAL HANDLER
+//
+
+//
+// The handler can interrupt the evaluator anywhere, including half-way
+// through pushing or dropping a frame, or in the middle of a recycle.  So it
+// sticks to what the runtime changes with single pointer-sized stores: the
+// FS_TOP pointer, and each frame's `prior`, `eval_type`, `original` and
+// `opt_label`.  It reads them directly instead of through accessors like
+// Is_Function_Frame(), which check invariants with asserts in debug builds
+// (and an assert can't be allowed to fire in a signal handler).
+//
+// Frames live on the C stack of the thread that evaluates, so any frame
+// pointer that isn't between the handler's own locals and the top of that
+// stack is one caught mid-update.  The walk stops there, and the sample is
+// marked as truncated.
+//
+
+#if !defined(TO_WINDOWS)
+
+bool findStackTop(uintptr_t & top) {
+#if defined(TO_OSX)
+    void * base = pthread_get_stackaddr_np(pthread_self()); // (the top)
+    top = reinterpret_cast<uintptr_t>(base);
+    return true;
+#else
+    pthread_attr_t attributes;
+    if (pthread_getattr_np(pthread_self(), &attributes) != 0)
+        return false;
+
+    void * base;
+    size_t size;
+    int result = pthread_attr_getstack(&attributes, &base, &size);
+    pthread_attr_destroy(&attributes);
+    if (result != 0)
+        return false;
+
+    top = reinterpret_cast<uintptr_t>(base) + size;
+    return true;
+#endif
+}
+
+
+void copyLabel(char (&out)[LabelSize], REBSTR * label) {
+    size_t n = 0;
+    if (label != nullptr) {
+        // Symbols are immutable once interned, and one that's the label of a
+        // running frame can't be freed while the GC isn't running
+        //
+        const char * spelling = cs_cast(STR_HEAD(label));
+        for (; n < LabelSize - 1 && spelling[n] != '\0'; ++n)
+            out[n] = spelling[n];
+    }
+    out[n] = '\0';
+}
+
+
+void sampleHandler(int signum) {
+    UNUSED(signum);
+
+    if (!running.load(std::memory_order_relaxed))
+        return;
+
+    // ITIMER_PROF counts the CPU time of the whole process, and the kernel
+    // delivers the signal to whichever thread it likes (usually the one
+    // that was on the CPU).  Only the thread that started the profiler owns
+    // the frame stack, so a tick that lands anywhere else is let go.  It
+    // isn't passed along with pthread_kill(), as that thread could have
+    // exited by now.
+    //
+    if (!pthread_equal(pthread_self(), target))
+        return;
+
+    size_t head = produced.load(std::memory_order_relaxed);
+    if (head - consumed.load(std::memory_order_acquire) >= Capacity) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Sample & sample = samples[head % Capacity];
+    sample.depth = 0;
+    sample.truncated = false;
+    sample.collecting = GC_Recycling;
+
+    // Everything the walk reads may be mid-sweep during a recycle
+    //
+    if (sample.collecting) {
+        produced.store(head + 1, std::memory_order_release);
+        return;
+    }
+
+    char here; // the stack grows down, so live frames are above this
+    uintptr_t bottom = reinterpret_cast<uintptr_t>(&here);
+
+    struct Reb_Frame *f = FS_TOP;
+    for (; f != nullptr; f = f->prior) {
+        uintptr_t address = reinterpret_cast<uintptr_t>(f);
+        if (address <= bottom || address >= stackTop) {
+            sample.truncated = true;
+            break;
+        }
+
+        if (f->eval_type != REB_FUNCTION)
+            continue; // e.g. a DO of a block, no function running
+
+        if (sample.depth == MaxDepth) {
+            sample.truncated = true;
+            break;
+        }
+
+        SampledFrame & frame = sample.frames[sample.depth++];
+        copyLabel(frame.label, f->opt_label);
+        frame.cpp = FUNC_DISPATCHER(f->original) == cppDispatcher;
+    }
+
+    produced.store(head + 1, std::memory_order_release);
+}
+
+#endif
+
+
+void appendLabel(std::string & out, SampledFrame const & frame) {
+    if (frame.label[0] == '\0')
+        out += "(anonymous)";
+    else
+        out += frame.label;
+
+    if (frame.cpp)
+        out += " [c++]";
+}
+
+} // end anonymous namespace
+
+
+
+//
+// PROFILER
+//
+
+Profiler::Profiler () {
+}
+
+
+Profiler::~Profiler () {
+    if (running.load())
+        stop();
+}
+
+
+void Profiler::start(std::chrono::microseconds interval) {
+#if defined(TO_WINDOWS)
+    UNUSED(interval);
+    throw std::runtime_error(
+        "ren::Profiler needs SIGPROF, which is not available on Windows"
+    );
+#else
+    if (running.load())
+        throw std::runtime_error("ren::Profiler is already running");
+
+    runtime.lazyInitializeIfNecessary();
+
+    if (!findStackTop(stackTop))
+        throw std::runtime_error("Couldn't find the stack of this thread");
+
+    target = pthread_self();
+    cppDispatcher = reinterpret_cast<REBNAT>(&Function::Ren_Cpp_Dispatcher);
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = &sampleHandler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART; // don't make the evaluator's I/O fail
+
+    if (sigaction(SIGPROF, &action, &previousAction) != 0)
+        throw std::runtime_error("Couldn't install SIGPROF handler");
+
+    running.store(true);
+
+    auto usec = interval.count();
+
+    struct itimerval timer;
+    timer.it_interval.tv_sec = static_cast<time_t>(usec / 1000000);
+    timer.it_interval.tv_usec = static_cast<suseconds_t>(usec % 1000000);
+    timer.it_value = timer.it_interval;
+
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        running.store(false);
+        sigaction(SIGPROF, &previousAction, nullptr);
+        throw std::runtime_error("Couldn't start profiling interval timer");
+    }
+#endif
+}
+
+
+void Profiler::stop() {
+#if !defined(TO_WINDOWS)
+    if (!running.load())
+        return;
+
+    struct itimerval timer;
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_PROF, &timer, nullptr);
+
+    running.store(false);
+    sigaction(SIGPROF, &previousAction, nullptr);
+#endif
+
+    drain();
+}
+
+
+bool Profiler::isRunning() const {
+    return running.load();
+}
+
+
+void Profiler::drain() {
+    std::lock_guard<std::mutex> lock (foldedMutex);
+
+    size_t tail = consumed.load(std::memory_order_relaxed);
+    size_t head = produced.load(std::memory_order_acquire);
+
+    std::string stack;
+
+    for (; tail != head; ++tail) {
+        Sample const & sample = samples[tail % Capacity];
+
+        // Frames were captured leaf first, but folded stacks are root first
+
+        stack.clear();
+        if (sample.truncated)
+            stack += "...";
+
+        if (sample.collecting)
+            stack += "(garbage collection)";
+
+        for (size_t i = sample.depth; i != 0; --i) {
+            if (!stack.empty())
+                stack += ';';
+            appendLabel(stack, sample.frames[i - 1]);
+        }
+
+        if (stack.empty())
+            stack += "(top level)";
+
+        ++foldedCounts[stack];
+        ++totalSamples;
+
+        // Give the slot back only once we're done reading it
+        //
+        consumed.store(tail + 1, std::memory_order_release);
+    }
+}
+
+
+void Profiler::reset() {
+    drain();
+
+    std::lock_guard<std::mutex> lock (foldedMutex);
+    foldedCounts.clear();
+    totalSamples = 0;
+    dropped.store(0);
+}
+
+
+size_t Profiler::sampleCount() const {
+    std::lock_guard<std::mutex> lock (foldedMutex);
+    return totalSamples;
+}
+
+
+size_t Profiler::droppedCount() const {
+    return dropped.load();
+}
+
+
+void Profiler::writeFolded(std::ostream & os) {
+    drain();
+
+    std::lock_guard<std::mutex> lock (foldedMutex);
+    for (auto const & entry : foldedCounts)
+        os << entry.first << ' ' << entry.second << '\n';
+}
+
+
+std::string Profiler::folded() {
+    std::ostringstream ss;
+    writeFolded(ss);
+    return ss.str();
+}
+
+} // end namespace ren
@@ -27,6 +27,7 @@
 #include "rencpp/engine.hpp"
 #include "rencpp/rebol.hpp"
 #include "rencpp/arrays.hpp"
+#include "rencpp/error.hpp"
 
 #include "common.hpp"
 
@@ -216,6 +217,10 @@ bool RebolRuntime::lazyInitializeIfNecessary() {
 
     Startup_Core();
 
+#if !defined(NDEBUG)
+    internal::checkCellLayout();
+#endif
+
     initialized = true;
 
     // Set up the interrupt handler for things like Ctrl-C (which had
@@ -344,4 +349,30 @@ optional<AnyValue> Runtime::evaluate(
     return nullopt;
 }
 
+
+Evaluation Runtime::tryEvaluate(
+    std::initializer_list<internal::Loadable> loadables,
+    Engine * engine
+) {
+    Evaluation outcome;
+    AnyValue result (AnyValue::Dont::Initialize);
+
+    AnyContext context = AnyContext::current(engine);
+
+    if (AnyValue::constructOrApplyInitialize(
+        context.getEngine(),
+        &context,
+        nullptr, // no applicand
+        loadables.begin(),
+        loadables.size(),
+        nullptr, // don't construct
+        &result, // do apply
+        &outcome // report errors and throws instead of raising them
+    )) {
+        outcome.value = result;
+    }
+
+    return outcome;
+}
+
 } // end namespace ren
@@ -0,0 +1,509 @@
+//
+// scheduler.cpp
+// This file is part of RenCpp
+// Copyright (C) 2015-2018 HostileFork.com
+//
+// Licensed under the Boost License, Version 1.0 (the "License")
+//
+//      http://www.boost.org/LICENSE_1_0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.  See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// See http://rencpp.hostilefork.com for more information on this project
+//
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "rencpp/scheduler.hpp"
+#include "rencpp/rebol.hpp"
+
+#include "common.hpp"
+
+
+namespace ren {
+
+using Clock = std::chrono::steady_clock;
+
+
+struct Task::State {
+    std::shared_ptr<Scheduler::Core> core;
+
+    std::string source;
+    int priority;
+
+    Status status;
+    Evaluation outcome;
+
+    bool cancelRequested;
+    bool haltIssued; // runtime.cancel() was called to halt this task
+    bool finishing; // evaluation is over, so it can't be halted any more
+
+    Clock::time_point submitted;
+    Clock::time_point resumed; // when it last became the top task
+    std::chrono::nanoseconds waited;
+    std::chrono::nanoseconds ran;
+};
+
+
+
+//
+// SCHEDULER STATE
+//
+
+//
+// Everything but `active` is guarded by the mutex.  Tasks that are running
+// are in `running` in the order they started, so the one on top (the one
+// the evaluator is actually in) is at the back.
+//
+// Finished tasks are kept in `retired` until nothing else holds them, so
+// the values in their results are let go of on the evaluating thread.
+//
+
+struct Scheduler::Core {
+    std::chrono::nanoseconds slice;
+    std::thread::id evaluator;
+
+    std::mutex mutex;
+    std::condition_variable changed; // submitted, finished, or stopping
+
+    std::map<
+        int, std::deque<std::shared_ptr<Task::State>>, std::greater<int>
+    > waiting;
+
+    std::vector<std::shared_ptr<Task::State>> running;
+    std::vector<std::shared_ptr<Task::State>> retired;
+
+    bool stopping;
+
+    // Read at every checkpoint without locking, so a checkpoint with nothing
+    // to do (the usual case) is cheap.  Set when a task is waiting, or when
+    // one that is running beneath others has been cancelled.
+    //
+    std::atomic<bool> attention;
+
+    void refresh();
+
+    std::shared_ptr<Task::State> takeNext(Task::State const * over);
+
+    void execute(
+        std::unique_lock<std::mutex> & lock,
+        std::shared_ptr<Task::State> task
+    );
+
+    void halt(Task::State & task);
+
+    void checkpoint();
+
+    void prune();
+};
+
+
+namespace {
+
+// The scheduler whose task is running, if any.  Only the evaluating thread
+// changes it (it isn't thread_local, because a Generator's script runs on a
+// thread of its own while the evaluating thread waits).
+//
+Scheduler::Core * active = nullptr;
+
+bool isFinished(Task::Status status) {
+    return status != Task::Status::Waiting
+        && status != Task::Status::Running;
+}
+
+} // end anonymous namespace
+
+
+void Scheduler::Core::refresh() {
+    bool cancelling = false;
+    for (auto const & task : running) {
+        if (task->cancelRequested && !task->haltIssued)
+            cancelling = true;
+    }
+    attention.store(!waiting.empty() || cancelling);
+}
+
+
+// The waiting task to run next: the oldest of the highest priority.  If a
+// task is running, only one that should interrupt it.
+//
+std::shared_ptr<Task::State> Scheduler::Core::takeNext(
+    Task::State const * over
+) {
+    if (waiting.empty())
+        return nullptr;
+
+    auto first = waiting.begin(); // highest priority, as map is descending
+
+    if (over) {
+        bool preempts = first->first > over->priority
+            || (
+                first->first == over->priority
+                && Clock::now() - over->resumed >= slice
+            );
+        if (!preempts)
+            return nullptr;
+    }
+
+    std::shared_ptr<Task::State> task = first->second.front();
+    first->second.pop_front();
+    if (first->second.empty())
+        waiting.erase(first);
+    return task;
+}
+
+
+void Scheduler::Core::halt(Task::State & task) {
+    task.haltIssued = true;
+    runtime.cancel();
+}
+
+
+void Scheduler::Core::execute(
+    std::unique_lock<std::mutex> & lock,
+    std::shared_ptr<Task::State> task
+) {
+    Clock::time_point now = Clock::now();
+    task->status = Task::Status::Running;
+    task->waited = now - task->submitted;
+    task->resumed = now;
+    running.push_back(task);
+    refresh();
+
+    Core * outer = active;
+    active = this;
+
+    lock.unlock();
+
+    Evaluation outcome;
+    try {
+        outcome = runtime.tryEvaluate({task->source.c_str()});
+    }
+    catch (...) {
+        outcome.status = Evaluation::Status::Errored; // e.g. out of memory
+    }
+
+    // A halt issued just as the task finished is still pending, and would
+    // stop whatever is evaluated next instead.  Nothing else can be halted
+    // while this task is still on top, so the halt is surely its own.
+
+    lock.lock();
+    task->finishing = true;
+    bool absorb = task->haltIssued
+        && outcome.status != Evaluation::Status::Halted;
+    lock.unlock();
+
+    if (absorb)
+        runtime.tryEvaluate({"none"});
+
+    lock.lock();
+
+    active = outer;
+
+    running.pop_back();
+    task->ran += Clock::now() - task->resumed;
+
+    switch (outcome.status) {
+    case Evaluation::Status::Completed:
+        task->status = Task::Status::Completed;
+        break;
+
+    case Evaluation::Status::Thrown:
+        task->status = Task::Status::Thrown;
+        break;
+
+    case Evaluation::Status::Errored:
+        task->status = Task::Status::Errored;
+        break;
+
+    case Evaluation::Status::Halted:
+        task->status = Task::Status::Cancelled;
+        break;
+
+    default:
+        UNREACHABLE_CODE();
+    }
+    task->outcome = std::move(outcome);
+
+    retired.push_back(std::move(task));
+    refresh();
+    changed.notify_all();
+}
+
+
+void Scheduler::Core::checkpoint() {
+    if (!attention.load())
+        return;
+
+    std::unique_lock<std::mutex> lock {mutex};
+
+    // Tasks run on top of the one interrupted one at a time, until it has
+    // nothing more urgent than itself waiting.  It gets a new slice each
+    // time it continues, so tasks of the same priority take turns.
+
+    while (!running.empty()) {
+        std::shared_ptr<Task::State> top = running.back();
+
+        // A halt for it is pending; anything started now would get it
+        //
+        if (top->haltIssued)
+            return;
+
+        if (top->cancelRequested) {
+            halt(*top);
+            refresh();
+            return;
+        }
+
+        if (running.size() >= MaxNesting)
+            return;
+
+        std::shared_ptr<Task::State> task = takeNext(top.get());
+        if (!task)
+            return;
+
+        top->ran += Clock::now() - top->resumed;
+        execute(lock, std::move(task));
+        top->resumed = Clock::now();
+    }
+}
+
+
+void Scheduler::Core::prune() {
+    retired.erase(
+        std::remove_if(
+            retired.begin(),
+            retired.end(),
+            [](std::shared_ptr<Task::State> const & task) {
+                return task.use_count() == 1;
+            }
+        ),
+        retired.end()
+    );
+}
+
+
+
+//
+// TASK
+//
+
+Task::Status Task::poll() const {
+    std::lock_guard<std::mutex> lock {state->core->mutex};
+    return state->status;
+}
+
+
+Task::Status Task::await() {
+    Scheduler::Core & core = *state->core;
+    std::unique_lock<std::mutex> lock {core.mutex};
+
+    if (std::this_thread::get_id() != core.evaluator) {
+        core.changed.wait(lock, [this]() {
+            return isFinished(state->status);
+        });
+        return state->status;
+    }
+
+    while (!isFinished(state->status)) {
+        if (state->status == Status::Running)
+            throw std::logic_error(
+                "ren::Task awaited by code running on top of it"
+            );
+
+        // It's waiting, so there is at least one task to run
+        //
+        core.execute(lock, core.takeNext(nullptr));
+    }
+
+    core.prune();
+    return state->status;
+}
+
+
+void Task::cancel() {
+    Scheduler::Core & core = *state->core;
+    std::lock_guard<std::mutex> lock {core.mutex};
+
+    if (state->status == Status::Waiting) {
+        auto queue = core.waiting.find(state->priority);
+        queue->second.erase(
+            std::find(queue->second.begin(), queue->second.end(), state)
+        );
+        if (queue->second.empty())
+            core.waiting.erase(queue);
+
+        state->status = Status::Cancelled;
+        state->outcome.status = Evaluation::Status::Halted;
+        state->waited = Clock::now() - state->submitted;
+
+        core.refresh();
+        core.changed.notify_all();
+        return;
+    }
+
+    if (
+        state->status != Status::Running
+        || state->finishing
+        || state->cancelRequested
+    ){
+        return;
+    }
+
+    // If other tasks are running on top of it, it is halted at the first
+    // checkpoint after they finish
+
+    state->cancelRequested = true;
+    if (core.running.back() == state)
+        core.halt(*state);
+    core.refresh();
+}
+
+
+Evaluation const & Task::result() const {
+    return state->outcome;
+}
+
+
+int Task::priority() const {
+    return state->priority;
+}
+
+
+std::chrono::nanoseconds Task::waitTime() const {
+    std::lock_guard<std::mutex> lock {state->core->mutex};
+    if (state->status == Status::Waiting)
+        return Clock::now() - state->submitted;
+    return state->waited;
+}
+
+
+std::chrono::nanoseconds Task::runTime() const {
+    Scheduler::Core & core = *state->core;
+    std::lock_guard<std::mutex> lock {core.mutex};
+
+    // The time since it was last resumed counts only if it is on top
+    //
+    if (
+        state->status == Status::Running
+        && !state->finishing
+        && core.running.back() == state
+    ){
+        return state->ran + (Clock::now() - state->resumed);
+    }
+    return state->ran;
+}
+
+
+
+//
+// SCHEDULER
+//
+
+Scheduler::Scheduler (std::chrono::milliseconds slice) :
+    checkpoint (Function::construct(
+        "{Let a task waiting in the scheduler run, if it's due}",
+
+        []() -> optional<AnyValue> {
+            return nullopt; // the dispatcher did it, as for any Function
+        }
+    )),
+    core (std::make_shared<Core>())
+{
+    core->slice = slice;
+    core->evaluator = std::this_thread::get_id();
+    core->stopping = false;
+    core->attention.store(false);
+}
+
+
+Scheduler::~Scheduler () {
+    std::lock_guard<std::mutex> lock {core->mutex};
+
+    for (auto & queue : core->waiting) {
+        for (auto & task : queue.second) {
+            task->status = Task::Status::Cancelled;
+            task->outcome.status = Evaluation::Status::Halted;
+            task->waited = Clock::now() - task->submitted;
+        }
+    }
+    core->waiting.clear();
+    core->retired.clear();
+    core->attention.store(false);
+    core->changed.notify_all();
+}
+
+
+Task Scheduler::submit(std::string source, int priority) {
+    std::shared_ptr<Task::State> state = std::make_shared<Task::State>();
+    state->core = core;
+    state->source = std::move(source);
+    state->priority = priority;
+    state->status = Task::Status::Waiting;
+    state->cancelRequested = false;
+    state->haltIssued = false;
+    state->finishing = false;
+    state->submitted = Clock::now();
+    state->waited = std::chrono::nanoseconds::zero();
+    state->ran = std::chrono::nanoseconds::zero();
+
+    std::lock_guard<std::mutex> lock {core->mutex};
+    core->waiting[priority].push_back(state);
+    core->attention.store(true);
+    core->changed.notify_all();
+
+    return Task {state};
+}
+
+
+void Scheduler::runPending() {
+    std::unique_lock<std::mutex> lock {core->mutex};
+
+    while (std::shared_ptr<Task::State> task = core->takeNext(nullptr)) {
+        core->execute(lock, std::move(task));
+        core->prune();
+    }
+}
+
+
+void Scheduler::run() {
+    std::unique_lock<std::mutex> lock {core->mutex};
+
+    while (!core->stopping) {
+        if (std::shared_ptr<Task::State> task = core->takeNext(nullptr)) {
+            core->execute(lock, std::move(task));
+            core->prune();
+        }
+        else
+            core->changed.wait(lock);
+    }
+    core->stopping = false;
+}
+
+
+void Scheduler::stop() {
+    std::lock_guard<std::mutex> lock {core->mutex};
+    core->stopping = true;
+    core->changed.notify_all();
+}
+
+
+void Scheduler::atCheckpoint() {
+    if (active)
+        active->checkpoint();
+}
+
+} // end namespace ren
@@ -93,6 +93,11 @@ size_t AnySeries::length() const {
 }
 
 
+size_t AnySeries::index() const {
+    return VAL_INDEX(cell);
+}
+
+
 AnyValue AnySeries::operator[](AnyValue const & picker) const {
     //
     // See notes on semantic questions of operator[] here, and why we go with
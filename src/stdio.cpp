@@ -24,6 +24,7 @@
 
 #include "rencpp/rebol.hpp"
 #include "rencpp/engine.hpp"
+#include "rencpp/metrics.hpp"
 
 #include "common.hpp"
 
@@ -142,6 +143,7 @@ extern REBDEV *Devices[];
     // could you do about partial output to stdout anyway?
 
     req->actual = req->length;
+    ren::metrics.outputBytes.add(req->length);
 
     return DR_DONE;
 }
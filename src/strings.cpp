@@ -1,34 +1,24 @@
+#include <cstring>
 #include <stdexcept>
+#include <vector>
 
 #include "rencpp/value.hpp"
 #include "rencpp/strings.hpp"
 #include "rencpp/engine.hpp"
+#include "rencpp/error.hpp"
 
 #include "common.hpp"
 
+#if defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define RENCPP_STRINGS_SSE2 1
+#else
+    #define RENCPP_STRINGS_SSE2 0
+#endif
 
-namespace ren {
-
-//
-// TYPE DETECTION
-//
-
-
-bool String::isValid(REBVAL const * cell) {
-    return IS_STRING(cell);
-}
-
-bool Tag::isValid(REBVAL const * cell) {
-    return IS_TAG(cell);
-}
-
-bool Filename::isValid(REBVAL const * cell) {
-    return IS_FILE(cell);
-}
 
-bool AnyString::isValid(REBVAL const * cell) {
-    return ANY_STRING(cell);
-}
+namespace ren {
 
 
 //
@@ -109,9 +99,158 @@ AnyString::AnyString (
 
 
 
-
 #if REN_CLASSLIB_QT == 1
 
+//
+// UTF-16 CONVERSION
+//
+
+//
+// Series hold either Latin-1 bytes or UCS-2 (the same as UTF-16, apart from
+// surrogate pairs), so text can move between a series and a QString by
+// copying or by widening/narrowing each character.  Most text is ASCII,
+// which is checked for and converted 8 or 16 characters at a time.
+//
+
+namespace {
+
+static_assert(
+    sizeof(REBUNI) == sizeof(ushort),
+    "Series characters must be the size of QString's UTF-16 units"
+);
+
+bool isAscii(ushort const * units, int size) {
+    int i = 0;
+
+#if RENCPP_STRINGS_SSE2
+    __m128i bits = _mm_setzero_si128();
+    for (; i + 8 <= size; i += 8)
+        bits = _mm_or_si128(
+            bits,
+            _mm_loadu_si128(reinterpret_cast<__m128i const *>(units + i))
+        );
+
+    __m128i highBits = _mm_and_si128(
+        bits, _mm_set1_epi16(static_cast<short>(0xFF80))
+    );
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(highBits, _mm_setzero_si128()))
+        != 0xFFFF
+    ){
+        return false;
+    }
+#endif
+
+    ushort high = 0;
+    for (; i < size; ++i)
+        high |= units[i];
+    return (high & 0xFF80) == 0;
+}
+
+
+// Every unit must be ASCII
+//
+void narrow(REBYTE * dest, ushort const * units, int size) {
+    int i = 0;
+
+#if RENCPP_STRINGS_SSE2
+    for (; i + 16 <= size; i += 16) {
+        __m128i lo = _mm_loadu_si128(
+            reinterpret_cast<__m128i const *>(units + i)
+        );
+        __m128i hi = _mm_loadu_si128(
+            reinterpret_cast<__m128i const *>(units + i + 8)
+        );
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i *>(dest + i), _mm_packus_epi16(lo, hi)
+        );
+    }
+#endif
+
+    for (; i < size; ++i)
+        dest[i] = static_cast<REBYTE>(units[i]);
+}
+
+
+void widen(ushort * dest, REBYTE const * bytes, int size) {
+    int i = 0;
+
+#if RENCPP_STRINGS_SSE2
+    __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= size; i += 16) {
+        __m128i chars = _mm_loadu_si128(
+            reinterpret_cast<__m128i const *>(bytes + i)
+        );
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i *>(dest + i),
+            _mm_unpacklo_epi8(chars, zero)
+        );
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i *>(dest + i + 8),
+            _mm_unpackhi_epi8(chars, zero)
+        );
+    }
+#endif
+
+    for (; i < size; ++i)
+        dest[i] = bytes[i];
+}
+
+
+// Returns nullptr for text with surrogate pairs, which a series can't hold
+// as characters.
+//
+REBSER * seriesFromQString(QString const & text) {
+    ushort const * units = text.utf16();
+    int size = text.size();
+
+    REBSER * series;
+
+    if (isAscii(units, size)) {
+        series = Make_Binary(static_cast<REBCNT>(size));
+        narrow(BIN_HEAD(series), units, size);
+    }
+    else {
+        for (int i = 0; i < size; ++i)
+            if (units[i] >= 0xD800 && units[i] <= 0xDFFF)
+                return nullptr;
+
+        series = Make_Unicode(static_cast<REBCNT>(size));
+        memcpy(
+            UNI_HEAD(series), units, static_cast<size_t>(size) * sizeof(REBUNI)
+        );
+    }
+
+    TERM_SEQUENCE_LEN(series, static_cast<REBCNT>(size));
+    MANAGE_SERIES(series);
+    return series;
+}
+
+} // end anonymous namespace
+
+
+QString internal::qStringFromCell(REBVAL const * cell) {
+    assert(ANY_STRING(cell));
+
+    REBSER * series = VAL_SERIES(cell);
+    REBCNT index = VAL_INDEX(cell);
+    int size = static_cast<int>(VAL_LEN_AT(cell));
+
+    QString result (size, Qt::Uninitialized);
+    ushort * dest = reinterpret_cast<ushort *>(result.data());
+
+    if (SER_WIDE(series) == 1)
+        widen(dest, BIN_AT(series, index), size);
+    else
+        memcpy(
+            dest,
+            UNI_AT(series, index),
+            static_cast<size_t>(size) * sizeof(REBUNI)
+        );
+
+    return result;
+}
+
+
 AnyString::AnyString (
     QString const & spelling,
     internal::CellFunction cellfun,
@@ -121,6 +260,20 @@ AnyString::AnyString (
 {
     (*cellfun)(cell);
 
+    if (engine == nullptr)
+        engine = &Engine::runFinder();
+
+    // The text becomes the series as it is, so unlike scanning `{...}` there
+    // is no need to worry about braces or escapes in it
+
+    if (REBSER * series = seriesFromQString(spelling)) {
+        Init_Any_Series(cell, VAL_TYPE(cell), series);
+        finishInit(engine->getHandle());
+        return;
+    }
+
+    // Surrogate pairs are left to the scanner to decide what to do with
+
     QString source;
 
     // Note: wouldn't be able to return char * without intermediate
@@ -136,15 +289,16 @@ AnyString::AnyString (
         source += spelling;
         source += '>';
     }
+    else if (hasType<Filename>(*this)) {
+        source += '%';
+        source += spelling;
+    }
     else
         UNREACHABLE_CODE();
 
     QByteArray utf8 = source.toUtf8();
     internal::Loadable loadable (utf8.data());
 
-    if (engine == nullptr)
-        engine = &Engine::runFinder();
-
     constructOrApplyInitialize(
         engine->getHandle(),
         nullptr, // no context
@@ -179,17 +333,638 @@ std::string AnyString::spellingOf_STD() const {
 #if REN_CLASSLIB_QT
 
 QString AnyString::spellingOf_QT() const {
-    QString result = static_cast<QString>(*this);
-    if (hasType<String>(*this) /* or isUrl() or isEmail() or isFile() */)
-        return result;
-    if (hasType<Tag>(*this)) {
-        assert(result.length() >= 2);
-        return result.mid(1, result.length() - 2);
-    }
+    if (hasType<String>(*this) || hasType<Tag>(*this))
+        return internal::qStringFromCell(cell);
     throw std::runtime_error {"Invalid String Type"};
 }
 
 #endif
 
 
+
+//
+// CODEPOINT ACCESS
+//
+
+//
+// Series characters are fixed width, so there is nothing to decode: Latin-1
+// bytes (which all ASCII text is stored as) and 16-bit characters are just
+// zero-extended.  SSE2 does that 16 or 8 characters at a time.
+//
+
+namespace {
+
+void widenBytes(char32_t * dest, REBYTE const * bytes, size_t size) {
+    size_t i = 0;
+
+#if RENCPP_STRINGS_SSE2
+    __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= size; i += 16) {
+        __m128i chars = _mm_loadu_si128(
+            reinterpret_cast<__m128i const *>(bytes + i)
+        );
+        __m128i lo = _mm_unpacklo_epi8(chars, zero);
+        __m128i hi = _mm_unpackhi_epi8(chars, zero);
+
+        __m128i * out = reinterpret_cast<__m128i *>(dest + i);
+        _mm_storeu_si128(out, _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi, zero));
+    }
+#endif
+
+    for (; i < size; ++i)
+        dest[i] = bytes[i];
+}
+
+
+void widenUnits(char32_t * dest, REBUNI const * units, size_t size) {
+    size_t i = 0;
+
+#if RENCPP_STRINGS_SSE2
+    __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= size; i += 8) {
+        __m128i chars = _mm_loadu_si128(
+            reinterpret_cast<__m128i const *>(units + i)
+        );
+
+        __m128i * out = reinterpret_cast<__m128i *>(dest + i);
+        _mm_storeu_si128(out, _mm_unpacklo_epi16(chars, zero));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(chars, zero));
+    }
+#endif
+
+    for (; i < size; ++i)
+        dest[i] = units[i];
+}
+
+} // end anonymous namespace
+
+
+AnyString::codepoint_range AnyString::codepoints() const {
+    REBSER * series = VAL_SERIES(cell);
+    bool wide = SER_WIDE(series) != 1;
+
+    void const * data = wide
+        ? static_cast<void const *>(UNI_HEAD(series))
+        : static_cast<void const *>(BIN_HEAD(series));
+
+    return codepoint_range {
+        codepoint_iterator {data, VAL_INDEX(cell), wide},
+        codepoint_iterator {data, SER_LEN(series), wide}
+    };
+}
+
+
+void AnyString::decodeInto(std::u32string & out) const {
+    REBSER * series = VAL_SERIES(cell);
+    REBCNT index = VAL_INDEX(cell);
+    size_t size = VAL_LEN_AT(cell);
+
+    out.resize(size);
+    if (size == 0)
+        return;
+
+    if (SER_WIDE(series) == 1)
+        widenBytes(&out[0], BIN_AT(series, index), size);
+    else
+        widenUnits(&out[0], UNI_AT(series, index), size);
+}
+
+
+
+//
+// SEARCHING
+//
+
+//
+// Needles are widened to codepoints once, and then SSE2 scans the series
+// for their first character 16 bytes (or 8 wide characters) at a time, so
+// only the places where it occurs get compared in full.
+//
+// Caseless comparison folds each character through LO_CASE, as Ren's own
+// string comparison does.  Latin-1 byte series can be scanned for the two
+// cased forms of the first character, but in wide series other characters
+// may fold to it too (e.g. the Kelvin sign to `k`), so caseless searches of
+// those compare at every position.
+//
+
+namespace {
+
+char32_t fold(char32_t c) {
+    return c < UNICODE_CASES ? LO_CASE(c) : c;
+}
+
+
+std::u32string decodeUtf8(char const * utf8) {
+    std::u32string result;
+
+    auto bytes = reinterpret_cast<unsigned char const *>(utf8);
+    while (*bytes != '\0') {
+        unsigned char lead = *bytes++;
+        if (lead < 0x80) {
+            result += lead;
+            continue;
+        }
+
+        int extra = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 0;
+        if (extra == 0 || lead > 0xF4)
+            throw std::runtime_error("Invalid UTF-8 in string search");
+
+        char32_t c = lead & (0x3F >> extra);
+        for (; extra > 0; --extra) {
+            if ((*bytes & 0xC0) != 0x80) // also stops at the terminator
+                throw std::runtime_error("Invalid UTF-8 in string search");
+            c = (c << 6) | (*bytes++ & 0x3F);
+        }
+        result += c;
+    }
+
+    return result;
+}
+
+
+// A string's characters from its index, in whichever width it is stored
+//
+struct Text {
+    REBYTE const * bytes; // null if wide
+    REBUNI const * units; // null if bytes
+    size_t size;
+
+    char32_t operator[](size_t i) const {
+        return bytes ? bytes[i] : units[i];
+    }
+};
+
+Text textOf(REBVAL const * cell) {
+    REBSER * series = VAL_SERIES(cell);
+    REBCNT index = VAL_INDEX(cell);
+
+    Text text;
+    text.size = VAL_LEN_AT(cell);
+    if (SER_WIDE(series) == 1) {
+        text.bytes = BIN_AT(series, index);
+        text.units = nullptr;
+    }
+    else {
+        text.bytes = nullptr;
+        text.units = UNI_AT(series, index);
+    }
+    return text;
+}
+
+
+#if RENCPP_STRINGS_SSE2
+
+unsigned lowestBit(int mask) {
+    unsigned n = 0;
+    for (; (mask & 1) == 0; mask >>= 1)
+        ++n;
+    return n;
+}
+
+#endif
+
+
+// Index of the first of `from` up to (not including) `to` that is `a` or
+// `b`, or `to` if there is none
+//
+size_t scanBytes(
+    REBYTE const * bytes, size_t from, size_t to, REBYTE a, REBYTE b
+) {
+    size_t i = from;
+
+#if RENCPP_STRINGS_SSE2
+    __m128i wantA = _mm_set1_epi8(static_cast<char>(a));
+    __m128i wantB = _mm_set1_epi8(static_cast<char>(b));
+    for (; i + 16 <= to; i += 16) {
+        __m128i chars = _mm_loadu_si128(
+            reinterpret_cast<__m128i const *>(bytes + i)
+        );
+        int hits = _mm_movemask_epi8(_mm_or_si128(
+            _mm_cmpeq_epi8(chars, wantA), _mm_cmpeq_epi8(chars, wantB)
+        ));
+        if (hits != 0)
+            return i + lowestBit(hits);
+    }
+#endif
+
+    for (; i < to; ++i)
+        if (bytes[i] == a || bytes[i] == b)
+            return i;
+    return to;
+}
+
+
+size_t scanUnits(
+    REBUNI const * units, size_t from, size_t to, REBUNI a, REBUNI b
+) {
+    size_t i = from;
+
+#if RENCPP_STRINGS_SSE2
+    __m128i wantA = _mm_set1_epi16(static_cast<short>(a));
+    __m128i wantB = _mm_set1_epi16(static_cast<short>(b));
+    for (; i + 8 <= to; i += 8) {
+        __m128i chars = _mm_loadu_si128(
+            reinterpret_cast<__m128i const *>(units + i)
+        );
+        int hits = _mm_movemask_epi8(_mm_or_si128(
+            _mm_cmpeq_epi16(chars, wantA), _mm_cmpeq_epi16(chars, wantB)
+        ));
+        if (hits != 0)
+            return i + lowestBit(hits) / 2; // two mask bits per unit
+    }
+#endif
+
+    for (; i < to; ++i)
+        if (units[i] == a || units[i] == b)
+            return i;
+    return to;
+}
+
+
+bool matchesAt(
+    Text const & text,
+    size_t at,
+    std::u32string const & needle,
+    bool caseless
+) {
+    for (size_t i = 0; i < needle.size(); ++i) {
+        char32_t c = text[at + i];
+        if (c != needle[i] && !(caseless && fold(c) == fold(needle[i])))
+            return false;
+    }
+    return true;
+}
+
+
+optional<size_t> search(
+    Text const & text,
+    std::u32string const & needle,
+    size_t from,
+    bool caseless
+) {
+    if (from > text.size || needle.size() > text.size - from)
+        return nullopt;
+    if (needle.empty())
+        return from;
+
+    size_t to = text.size - needle.size() + 1; // past the last start
+
+    // The characters to scan for, which will be the same unless caseless
+
+    bool scan = true;
+    char32_t a = needle[0];
+    char32_t b = a;
+
+    if (caseless) {
+        if (text.units)
+            scan = false;
+        else {
+            a = fold(a);
+            b = a < UNICODE_CASES ? UP_CASE(a) : a;
+        }
+    }
+
+    if (scan) {
+        char32_t most = text.bytes ? 0xFF : 0xFFFF;
+        if (a > most && b > most)
+            return nullopt; // can't be stored in this series
+        if (a > most)
+            a = b;
+        if (b > most)
+            b = a;
+    }
+
+    for (size_t i = from; i < to; ++i) {
+        if (scan) {
+            i = text.bytes
+                ? scanBytes(
+                    text.bytes, i, to,
+                    static_cast<REBYTE>(a), static_cast<REBYTE>(b)
+                )
+                : scanUnits(
+                    text.units, i, to,
+                    static_cast<REBUNI>(a), static_cast<REBUNI>(b)
+                );
+            if (i == to)
+                break;
+        }
+
+        if (matchesAt(text, i, needle, caseless))
+            return i;
+    }
+
+    return nullopt;
+}
+
+
+// ASCII letters are folded 16 at a time by setting their 0x20 bit.  From the
+// first block with a Latin-1 character in it, LO_CASE is used instead.
+//
+bool equalBytesCaseless(REBYTE const * a, REBYTE const * b, size_t size) {
+    size_t i = 0;
+
+#if RENCPP_STRINGS_SSE2
+    __m128i beforeA = _mm_set1_epi8('A' - 1);
+    __m128i afterZ = _mm_set1_epi8('Z' + 1);
+    __m128i caseBit = _mm_set1_epi8(0x20);
+
+    auto lower = [&](__m128i chars) {
+        __m128i upper = _mm_and_si128(
+            _mm_cmpgt_epi8(chars, beforeA), _mm_cmplt_epi8(chars, afterZ)
+        );
+        return _mm_or_si128(chars, _mm_and_si128(upper, caseBit));
+    };
+
+    for (; i + 16 <= size; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<__m128i const *>(a + i));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<__m128i const *>(b + i));
+        if (_mm_movemask_epi8(_mm_or_si128(x, y)) != 0)
+            break;
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(lower(x), lower(y))) != 0xFFFF)
+            return false;
+    }
+#endif
+
+    for (; i < size; ++i)
+        if (a[i] != b[i] && fold(a[i]) != fold(b[i]))
+            return false;
+    return true;
+}
+
+} // end anonymous namespace
+
+
+optional<size_t> AnyString::find(
+    AnyString const & needle, size_t from
+) const {
+    std::u32string chars;
+    needle.decodeInto(chars);
+    return search(textOf(cell), chars, from, false);
+}
+
+
+optional<size_t> AnyString::find(char const * needle, size_t from) const {
+    return search(textOf(cell), decodeUtf8(needle), from, false);
+}
+
+
+optional<size_t> AnyString::findCaseless(
+    AnyString const & needle, size_t from
+) const {
+    std::u32string chars;
+    needle.decodeInto(chars);
+    return search(textOf(cell), chars, from, true);
+}
+
+
+optional<size_t> AnyString::findCaseless(
+    char const * needle, size_t from
+) const {
+    return search(textOf(cell), decodeUtf8(needle), from, true);
+}
+
+
+bool AnyString::isEqualToCaseless(AnyString const & other) const {
+    Text text = textOf(cell);
+    Text otherText = textOf(other.cell);
+
+    if (text.size != otherText.size)
+        return false;
+
+    if (text.bytes && otherText.bytes)
+        return equalBytesCaseless(text.bytes, otherText.bytes, text.size);
+
+    std::u32string chars;
+    other.decodeInto(chars);
+    return matchesAt(text, 0, chars, true);
+}
+
+
+bool AnyString::isEqualToCaseless(char const * text) const {
+    Text ours = textOf(cell);
+    std::u32string chars = decodeUtf8(text);
+
+    return ours.size == chars.size() && matchesAt(ours, 0, chars, true);
+}
+
+
+Block AnyString::split(char32_t delimiter) const {
+    Text text = textOf(cell);
+
+    // Found before anything is allocated, so the `fail` path (a longjmp)
+    // only skips frames which have nothing to destruct.
+
+    std::vector<size_t> ends;
+
+    bool storable = text.bytes ? delimiter <= 0xFF : delimiter <= 0xFFFF;
+    for (size_t i = 0; storable; ++i) {
+        i = text.bytes
+            ? scanBytes(
+                text.bytes, i, text.size,
+                static_cast<REBYTE>(delimiter), static_cast<REBYTE>(delimiter)
+            )
+            : scanUnits(
+                text.units, i, text.size,
+                static_cast<REBUNI>(delimiter), static_cast<REBUNI>(delimiter)
+            );
+        if (i == text.size)
+            break;
+        ends.push_back(i);
+    }
+    ends.push_back(text.size);
+
+    DECLARE_LOCAL (out);
+
+    REBCTX * error;
+    struct Reb_State state;
+
+    PUSH_UNHALTABLE_TRAP(&error, &state);
+
+// The first time through the following code 'error' will be NULL, but...
+// `fail` can longjmp here, so 'error' won't be NULL *if* that happens!
+
+    if (error) {
+        AnyValue errorValue;
+        Init_Error(errorValue.cell, error);
+        throw evaluation_error {static_cast<Error>(errorValue)};
+    }
+
+    REBSER * series = VAL_SERIES(cell);
+    REBCNT index = VAL_INDEX(cell);
+    enum Reb_Kind kind = VAL_TYPE(cell);
+
+    REBARR * array = Make_Array(static_cast<REBCNT>(ends.size()));
+
+    size_t start = 0;
+    for (size_t end : ends) {
+        REBSER * piece = Copy_Sequence_At_Len(
+            series,
+            index + static_cast<REBCNT>(start),
+            static_cast<REBCNT>(end - start)
+        );
+        MANAGE_SERIES(piece);
+        Init_Any_Series(Alloc_Tail_Array(array), kind, piece);
+
+        start = end + 1;
+    }
+
+    Init_Block(out, array);
+
+    DROP_TRAP_SAME_STACKLEVEL_AS_PUSH(&state);
+
+    return AnyValue::fromCell_<Block>(out, origin);
+}
+
+
+Function AnyString::findFunction() {
+    return Function::construct(
+        "{Find text in a string, without FIND's overhead}"
+        " series [any-string!]"
+        " value [any-string!]"
+        " /case {Characters are case-sensitive}",
+
+        [](
+            AnyString const & series,
+            AnyString const & value,
+            AnyValue const & exact
+        )
+            -> AnyValue
+        {
+            optional<size_t> offset = exact.isTruthy()
+                ? series.find(value)
+                : series.findCaseless(value);
+
+            if (!offset)
+                return AnyValue {}; // blank
+
+            AnyString result = series;
+            VAL_INDEX(result.cell) += static_cast<REBCNT>(*offset);
+            return result;
+        }
+    );
+}
+
+
+Function AnyString::splitFunction() {
+    return Function::construct(
+        "{Pieces of a string between each delimiter, as new strings}"
+        " series [any-string!]"
+        " delimiter [char!]",
+
+        [](AnyString const & series, Character const & delimiter) -> Block {
+            return series.split(
+                static_cast<char32_t>(delimiter.codepoint())
+            );
+        }
+    );
+}
+
+
+
+//
+// BORROWED STRING
+//
+
+namespace {
+
+bool isAscii(char const * data, size_t size) {
+    size_t i = 0;
+
+#if RENCPP_STRINGS_SSE2
+    __m128i highBits = _mm_setzero_si128();
+    for (; i + 16 <= size; i += 16)
+        highBits = _mm_or_si128(
+            highBits,
+            _mm_loadu_si128(reinterpret_cast<__m128i const *>(data + i))
+        );
+    if (_mm_movemask_epi8(highBits) != 0)
+        return false;
+#endif
+
+    unsigned char highBit = 0;
+    for (; i < size; ++i)
+        highBit |= static_cast<unsigned char>(data[i]);
+    return (highBit & 0x80) == 0;
+}
+
+// What a borrowed series is left pointing at once the borrow is over
+//
+REBYTE emptyText[1] = {'\0'};
+
+} // end anonymous namespace
+
+
+BorrowedString::BorrowedString (
+    char const * data,
+    size_t size,
+    Terminator terminator,
+    Engine * engine
+) :
+    String (Dont::Initialize),
+    series (nullptr)
+{
+    if (engine == nullptr)
+        engine = &Engine::runFinder();
+
+    // `data[size]` is only read if the caller said it's there
+
+    bool terminated = terminator == Terminator::Present
+        && data[size] == '\0';
+
+    if (terminated && isAscii(data, size)) {
+        //
+        // ASCII is valid Latin-1, so the bytes can be used as they are.  The
+        // series is marked external so neither expanding it nor the GC will
+        // try to free the caller's memory.
+        //
+        REBSER * ser = Make_Series_Core(
+            static_cast<REBCNT>(size + 1), sizeof(REBYTE), MKS_EXTERNAL
+        );
+        SER_SET_EXTERNAL_DATA(ser, const_cast<char *>(data));
+        SET_SERIES_LEN(ser, static_cast<REBCNT>(size));
+        SET_SER_INFO(ser, SERIES_INFO_PROTECTED);
+        SET_SER_INFO(ser, SERIES_INFO_FROZEN); // so UNPROTECT can't undo it
+        MANAGE_SERIES(ser);
+
+        Init_String(cell, ser);
+        series = ser;
+    }
+    else {
+        REBCTX *error;
+        struct Reb_State state;
+
+        PUSH_UNHALTABLE_TRAP(&error, &state);
+
+// The first time through the following code 'error' will be NULL, but...
+// `fail` can longjmp here, so 'error' won't be NULL *if* that happens!
+
+        if (error != NULL)
+            throw std::runtime_error("Invalid UTF-8 in BorrowedString");
+
+        Init_String(
+            cell,
+            Make_UTF8_May_Fail(cb_cast(data), static_cast<REBCNT>(size))
+        );
+
+        DROP_TRAP_SAME_STACKLEVEL_AS_PUSH(&state);
+    }
+
+    finishInit(engine->getHandle());
+}
+
+
+BorrowedString::~BorrowedString () {
+    if (series == nullptr)
+        return;
+
+    REBSER * ser = static_cast<REBSER *>(series);
+    SER_SET_EXTERNAL_DATA(ser, emptyText);
+    SET_SERIES_LEN(ser, 0);
+}
+
+
 } // end namespace ren
@@ -20,6 +20,7 @@
 #include <vector>
 #include <iostream>
 #include <array>
+#include <chrono>
 #include <stdexcept>
 
 #include "rencpp/value.hpp"
@@ -27,6 +28,7 @@
 #include "rencpp/context.hpp"
 #include "rencpp/runtime.hpp"
 #include "rencpp/error.hpp"
+#include "rencpp/metrics.hpp"
 #include "rencpp/strings.hpp"
 
 #include "rencpp/rebol.hpp" // ren::internal::nodes
@@ -100,6 +102,130 @@ optional<AnyValue> AnyValue::apply(
 }
 
 
+//
+// LOADER
+//
+
+//
+// Puts the values of a run of loadables at the tail of an array.  Cells are
+// copied, source text is scanned (and bound into the context, if there is
+// one), and nested brace lists become arrays that are filled by recursing.
+// So all of `Block {1, {2, {3, 4}}, "a b"}` is built in one pass under the
+// caller's trap, instead of a separate construction for each pair of braces
+// that is then copied into its parent.
+//
+// Since `fail` may longjmp out of here, nothing in it may have a destructor.
+//
+
+namespace internal {
+
+class Loader {
+public:
+    static void append(
+        REBARR * array,
+        Loadable const loadables[],
+        size_t numLoadables,
+        REBCTX * context
+    );
+};
+
+
+void Loader::append(
+    REBARR * array,
+    Loadable const loadables[],
+    size_t numLoadables,
+    REBCTX * context
+) {
+    for (size_t index = 0; index < numLoadables; index++) {
+        Loadable const & loadable = loadables[index];
+        REBVAL * cell = loadable.cell;
+
+        if (loadable.nestedCellFunction) {
+            REBARR * nested = Make_Array(
+                static_cast<REBCNT>(loadable.numNested)
+            );
+            append(nested, loadable.nested, loadable.numNested, context);
+
+            // The loadable's own cell holds the array, which keeps it alive
+            // until the aggregate is made into a value
+
+            (*loadable.nestedCellFunction)(cell);
+            Init_Any_Array(cell, VAL_TYPE(cell), nested);
+            Append_Value(array, cell);
+            continue;
+        }
+
+        if (VAL_TYPE_RAW(cell) == REB_0) {
+
+            // This is our "Alien" type that wants to get loaded (voids
+            // cannot be legally loaded into blocks, by design).  Key
+            // to his loading problem is that he wants to know whether
+            // he is an explicit or implicit block type.  So that means
+            // discerning between "foo bar" and "[foo bar]", which we
+            // get through transcode which returns [foo bar] and
+            // [[foo bar]] that discern the cases
+
+            auto loadText = reinterpret_cast<REBYTE*>(
+                cell->payload.handle.data.pointer // not really REB_HANDLE
+            );
+
+            // !!! Temporary: we can't let the GC see a REB_0 trash.
+            // There will be a REB_LOADABLE and ET_LOADABLE type, so use
+            // that when it arrives, but until then blank it.
+            //
+            Init_Unreadable_Blank(cell);
+
+            // CAN raise errors and longjmp backwards on the C stack to
+            // the `if (error)` case in constructOrApplyInitialize()!  These
+            // are the errors that happen if the input is bad (unmatched
+            // parens, etc...)
+
+            const char *rebol_hooks_utf8 = "rebol-hooks.cpp";
+            REBSTR *rebol_hooks_filename = Intern_UTF8_Managed(
+                cb_cast(rebol_hooks_utf8), strlen(rebol_hooks_utf8)
+            );
+
+            REBCNT loadLength = LEN_BYTES(loadText);
+            metrics.scannedBytes.add(loadLength);
+
+            REBARR * transcoded = Scan_UTF8_Managed(
+                rebol_hooks_filename, loadText, loadLength
+            );
+
+            // New words are added to the context; the caller resolves them
+            // against lib once everything is loaded
+
+            if (context) {
+                if (CTX_LEN(context) > 0)
+                    ASSERT_VALUE_MANAGED(ARR_HEAD(transcoded));
+
+                Bind_Values_All_Deep(ARR_HEAD(transcoded), context);
+            }
+
+            // Might think to use Append_Block here, but it's under
+            // an #ifdef and apparently unused.  This is its definition.
+
+            Insert_Series(
+                SER(array),
+                ARR_LEN(array),
+                reinterpret_cast<REBYTE*>(ARR_HEAD(transcoded)),
+                ARR_LEN(transcoded)
+            );
+
+            // transcoded series is managed, can't free it...
+        }
+        else {
+            // Just an ordinary value cell
+            ASSERT_VALUE_MANAGED(cell);
+            Append_Value(array, cell);
+        }
+    }
+}
+
+} // end namespace internal
+
+
+
 //
 // The concept of ConstructOrApply was to make one primitive that could LOAD,
 // splice blocks, evaluate without making a block out of the result, etc.
@@ -123,7 +249,8 @@ bool AnyValue::constructOrApplyInitialize(
     internal::Loadable const loadables[],
     size_t numLoadables,
     AnyValue * constructOutTypeIn,
-    AnyValue * applyOut
+    AnyValue * applyOut,
+    Evaluation * outcome
 ) {
     AnyValue extraOut {AnyValue::Dont::Initialize};
 
@@ -153,19 +280,26 @@ bool AnyValue::constructOrApplyInitialize(
             // cancellation in middle of interpretation from outside
             // the evaluation loop (e.g. Escape).
             //
+            if (outcome) {
+                outcome->status = Evaluation::Status::Halted;
+                return false;
+            }
             throw evaluation_halt {};
         }
 
         Init_Error(extraOut.cell, error);
-        
-        if (applying) {
-            extraOut->finishInit(engine);
-            assert(hasType<Error>(extraOut));
-            throw evaluation_error {static_cast<Error>(extraOut)};
-        }
-
         extraOut.finishInit(engine);
         assert(hasType<Error>(extraOut));
+
+        if (outcome) {
+            outcome->status = Evaluation::Status::Errored;
+            outcome->error = static_cast<Error>(extraOut);
+            return false;
+        }
+
+        if (applying)
+            throw evaluation_error {static_cast<Error>(extraOut)};
+
         throw load_error {static_cast<Error>(extraOut)};
     }
 
@@ -184,13 +318,6 @@ bool AnyValue::constructOrApplyInitialize(
         assert(applyOut);
     }
 
-    // We don't necessarily have a pointer to an array of REBVALs if
-    // sizeof loadable != sizeof(REBVAL); so keep "current" as char*
-    //
-    auto current = reinterpret_cast<char const *>(
-        numLoadables != 0 ? &loadables[0].cell : nullptr
-    );
-
     // For the initial state of the binding we'll focus on correctness
     // instead of optimization.  That means we'll take the "loadables"
     // and form a block out of them--even when we weren't asked to,
@@ -201,86 +328,27 @@ bool AnyValue::constructOrApplyInitialize(
     // initial string.  If we were asking to construct a non-block type,
     // then it should be the first element in this block.
 
-    for (size_t index = 0; index < numLoadables; index++) {
-
-        auto cell = *reinterpret_cast<REBVAL *const *>(current);
-
-        if (VAL_TYPE_RAW(cell) == REB_0) {
-
-            // This is our "Alien" type that wants to get loaded (voids
-            // cannot be legally loaded into blocks, by design).  Key
-            // to his loading problem is that he wants to know whether
-            // he is an explicit or implicit block type.  So that means
-            // discerning between "foo bar" and "[foo bar]", which we
-            // get through transcode which returns [foo bar] and
-            // [[foo bar]] that discern the cases
-
-            auto loadText = reinterpret_cast<REBYTE*>(
-                cell->payload.handle.data.pointer // not really REB_HANDLE
-            );
-
-            // !!! Temporary: we can't let the GC see a REB_0 trash.
-            // There will be a REB_LOADABLE and ET_LOADABLE type, so use
-            // that when it arrives, but until then blank it.
-            //
-            Init_Unreadable_Blank(cell);
+    REBCTX * c = context ? VAL_CONTEXT(context->cell) : nullptr;
+    REBCNT lenBeforeBinding = c ? CTX_LEN(c) : 0;
 
-            // CAN raise errors and longjmp backwards on the C stack to
-            // the `if (error)` case above!  These are the errors that
-            // happen if the input is bad (unmatched parens, etc...)
+    internal::Loader::append(aggregate, loadables, numLoadables, c);
 
-            const char *rebol_hooks_utf8 = "rebol-hooks.cpp";
-            REBSTR *rebol_hooks_filename = Intern_UTF8_Managed(
-                cb_cast(rebol_hooks_utf8), strlen(rebol_hooks_utf8)
-            );
-
-            REBARR * transcoded = Scan_UTF8_Managed(
-                rebol_hooks_filename, loadText, LEN_BYTES(loadText)
-            );
-
-            if (context) {
-                // Binding Do_String did by default...except it only
-                // worked with the user context.  Fell through to lib.
-
-                REBCTX *c = VAL_CONTEXT(context->cell);
-                REBCNT len = CTX_LEN(c);
-
-                if (len > 0)
-                    ASSERT_VALUE_MANAGED(ARR_HEAD(transcoded));
-
-                Bind_Values_All_Deep(ARR_HEAD(transcoded), c);
-
-                DECLARE_LOCAL (vali);
-                Init_Integer(vali, len);
-
-                Resolve_Context(
-                    c,
-                    Lib_Context,
-                    vali,
-                    FALSE, // !all
-                    FALSE // !expand
-                );
-            }
-
-            // Might think to use Append_Block here, but it's under
-            // an #ifdef and apparently unused.  This is its definition.
-
-            Insert_Series(
-                SER(aggregate),
-                ARR_LEN(aggregate),
-                reinterpret_cast<REBYTE*>(ARR_HEAD(transcoded)),
-                ARR_LEN(transcoded)
-            );
-
-            // transcoded series is managed, can't free it...
-        }
-        else {
-            // Just an ordinary value cell
-            ASSERT_VALUE_MANAGED(cell);
-            Append_Value(aggregate, cell);
-        }
-
-        current += sizeof(internal::Loadable);
+    if (c && CTX_LEN(c) > lenBeforeBinding) {
+        //
+        // Binding Do_String did by default...except it only worked with
+        // the user context.  Fell through to lib.  Words the binding added
+        // to the context are resolved once here, not once per source text.
+
+        DECLARE_LOCAL (vali);
+        Init_Integer(vali, lenBeforeBinding);
+
+        Resolve_Context(
+            c,
+            Lib_Context,
+            vali,
+            FALSE, // !all
+            FALSE // !expand
+        );
     }
 
     if (constructOutTypeIn) {
@@ -374,17 +442,41 @@ bool AnyValue::constructOrApplyInitialize(
             is_aggregate_managed = TRUE;
         }
 
-        if (Generalized_Apply_Throws(
+        metrics.evaluations.add();
+
+        // (A time_point has no destructor, so a longjmp past it is fine)
+        //
+        auto started = std::chrono::steady_clock::now();
+
+        bool threw = Generalized_Apply_Throws(
             applyOut->cell,
             applicand ? applicand->cell : nullptr,
             aggregate, // implicitly protected by the evaluator
             SPECIFIED // the aggregate is all REBVALs, fully specified
-        )) {
+        );
+
+        metrics.applySeconds.observe(
+            std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - started
+            ).count()
+        );
+
+        if (threw) {
             DROP_TRAP_SAME_STACKLEVEL_AS_PUSH(&state);
 
             CATCH_THROWN(extraOut.cell, applyOut->cell);
             bool hasName = applyOut->tryFinishInit(engine);
             bool hasValue = extraOut->tryFinishInit(engine);
+
+            if (outcome) {
+                outcome->status = Evaluation::Status::Thrown;
+                if (hasValue)
+                    outcome->value = extraOut;
+                if (hasName)
+                    outcome->name = *applyOut;
+                return false;
+            }
+
             throw evaluation_throw {
                 hasValue ? optional<AnyValue>{extraOut} : nullopt,
                 hasName ? optional<AnyValue>{*applyOut} : nullopt
@@ -449,8 +541,14 @@ internal::Loadable::Loadable (QString const & source) :
 // it cannot be safely freed.  Bad traversal pointers combined with bad data
 // would be a problem.  Review this issue.
 
-AnyValue::AnyValue (Dont)
+AnyValue::AnyValue (Dont dont)
 {
+    if (dont == Dont::Allocate) {
+        cell = nullptr; // borrower will point it at someone else's cell
+        origin = REN_ENGINE_HANDLE_INVALID;
+        return;
+    }
+
     runtime.lazyInitializeIfNecessary();
 
     // We make a pairing of values, where the key stores extra tracking info.
@@ -469,6 +567,8 @@ AnyValue::AnyValue (Dont)
     // will be deep marked for GC.
     //
     SET_VAL_FLAG(key, NODE_FLAG_ROOT);
+
+    metrics.liveRoots.add();
 }
 
 
@@ -558,6 +658,7 @@ bool AnyValue::tryFinishInit(RenEngineHandle engine) {
 void AnyValue::uninitialize() {
 
     Free_Pairing(cell);
+    metrics.liveRoots.subtract();
 
     // drop refcount here
 
@@ -716,6 +817,11 @@ std::string to_string(AnyValue const & value) {
 
 QString to_QString(AnyValue const & value) {
 
+    // FORM of a STRING! is its characters, which can be copied directly
+
+    if (IS_STRING(value.cell))
+        return internal::qStringFromCell(value.cell);
+
     // Currently, PUSH_UNHALTABLE_TRAP sets up the stack limit.  Anything that
     // calls C_STACK_OVERFLOWING(), e.g. MOLD, must have the Stack_Limit set
     // correctly for the running thread.
@@ -809,6 +915,22 @@ Loadable::Loadable (char const * sourceCstr) :
 }
 
 
+Loadable::Loadable (
+    Loadable const nested[],
+    size_t numNested,
+    CellFunction cellfun
+) :
+    AnyValue (AnyValue::Dont::Initialize),
+    nested (nested),
+    numNested (numNested),
+    nestedCellFunction (cellfun)
+{
+    // The cell stays a BLANK! until the Loader puts the array in it
+
+    origin = REN_ENGINE_HANDLE_INVALID;
+}
+
+
 Loadable::Loadable (optional<AnyValue> const & value) :
     AnyValue (AnyValue::Dont::Initialize)
 {
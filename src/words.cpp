@@ -9,39 +9,6 @@
 
 namespace ren {
 
-//
-// TYPE DETECTION
-//
-
-bool Word::isValid(const REBVAL *cell) {
-    return IS_WORD(cell);
-}
-
-bool SetWord::isValid(const REBVAL *cell) {
-    return IS_SET_WORD(cell);
-}
-
-bool GetWord::isValid(const REBVAL *cell) {
-    return IS_GET_WORD(cell);
-}
-
-bool LitWord::isValid(const REBVAL *cell) {
-    return IS_LIT_WORD(cell);
-}
-
-bool Refinement::isValid(const REBVAL *cell) {
-    return IS_REFINEMENT(cell);
-}
-
-bool AnyWord::isValid(const REBVAL *cell) {
-    return IS_WORD(cell)
-        || IS_SET_WORD(cell)
-        || IS_GET_WORD(cell)
-        || IS_LIT_WORD(cell)
-        || IS_REFINEMENT(cell)
-        || IS_ISSUE(cell);
-}
-
 
 //
 // TYPE HEADER INITIALIZATION
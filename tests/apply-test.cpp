@@ -1,5 +1,6 @@
 #include <iostream>
 #include <cassert>
+#include <string>
 
 #include "rencpp/ren.hpp"
 
@@ -35,3 +36,48 @@ TEST_CASE("apply test", "[rebol] [apply]")
         );
     }
 }
+
+
+TEST_CASE("non-throwing evaluation test", "[rebol] [apply]")
+{
+    SECTION("completed")
+    {
+        Evaluation outcome = runtime.tryEvaluate({"1 + 2"});
+        CHECK(outcome.status == Evaluation::Status::Completed);
+        CHECK(outcome.value->isEqualTo(Integer {3}));
+        CHECK(outcome.error == nullopt);
+    }
+
+    SECTION("thrown")
+    {
+        Evaluation outcome = runtime.tryEvaluate({"throw/name 10 'done"});
+        CHECK(outcome.status == Evaluation::Status::Thrown);
+        CHECK(outcome.value->isEqualTo(Integer {10}));
+        CHECK(outcome.name->isEqualTo(Word {"done"}));
+    }
+
+    SECTION("errored")
+    {
+        Evaluation outcome = runtime.tryEvaluate({"1 / 0"});
+        CHECK(outcome.status == Evaluation::Status::Errored);
+        CHECK(outcome.error != nullopt);
+        CHECK(outcome.value == nullopt);
+    }
+
+    SECTION("load error")
+    {
+        Evaluation outcome = runtime.tryEvaluate({"1 + {"});
+        CHECK(outcome.status == Evaluation::Status::Errored);
+    }
+
+    SECTION("what() is still available from exceptions")
+    {
+        try {
+            runtime("throw 1020");
+            FAIL("THROW didn't throw");
+        }
+        catch (evaluation_throw const & t) {
+            CHECK(std::string {t.what()} == "THROW: 1020");
+        }
+    }
+}
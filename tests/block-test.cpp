@@ -53,4 +53,23 @@ TEST_CASE("block test", "[rebol] [block]")
         CHECK(hasType<Logic>(blk2[1]));
         CHECK(hasType<Integer>(blk2[2]));
     }
+
+    SECTION("deeply nested")
+    {
+        Block blk { {1, "a b", {2, {}, {"c", 3}}}, {} };
+
+        CHECK(blk.length() == 2);
+
+        Block outer = static_cast<Block>(blk[1]);
+        CHECK(outer.length() == 4); // source text `a b` is two words
+        CHECK(hasType<Word>(outer[2]));
+        CHECK(hasType<Word>(outer[3]));
+
+        Block inner = static_cast<Block>(outer[4]);
+        CHECK(inner.length() == 3);
+        CHECK(static_cast<Block>(inner[2]).length() == 0);
+        CHECK(hasType<Word>(static_cast<Block>(inner[3])[1]));
+
+        CHECK(static_cast<Block>(blk[2]).length() == 0);
+    }
 }
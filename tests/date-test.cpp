@@ -0,0 +1,73 @@
+#include <chrono>
+#include <vector>
+
+#include "rencpp/ren.hpp"
+
+using namespace ren;
+
+#include "catch.hpp"
+
+using std::chrono::hours;
+using std::chrono::minutes;
+using std::chrono::seconds;
+using std::chrono::system_clock;
+
+
+TEST_CASE("date and time conversion test", "[rebol] [date]")
+{
+    system_clock::time_point epoch {};
+
+    SECTION("time")
+    {
+        Time time {seconds {90}};
+        CHECK(mold(time).text == "0:01:30");
+
+        Time hour = static_cast<Time>(*runtime("1:00"));
+        CHECK(hour.duration() == hours {1});
+    }
+
+    SECTION("date from time point")
+    {
+        Date date {epoch + seconds {1000000000}, hours {2}};
+
+        CHECK(mold(date).text == "9-Sep-2001/3:46:40+2:00");
+        CHECK(date.zone() == hours {2});
+        CHECK(date.timePoint() == epoch + seconds {1000000000});
+    }
+
+    SECTION("time point from date")
+    {
+        Date date = static_cast<Date>(*runtime("1-Jan-2000/10:00+2:00"));
+        CHECK(date.timePoint() == epoch + seconds {946713600});
+
+        Date day = static_cast<Date>(*runtime("1-Jan-2000"));
+        CHECK(!day.hasTime());
+        CHECK(day.timePoint() == epoch + seconds {946684800});
+
+        Date old = static_cast<Date>(*runtime("1-Mar-1900/0:00"));
+        CHECK(old.timePoint() == epoch - seconds {2203891200});
+
+        // Past what nanoseconds since the epoch can count to
+        //
+        Date far = static_cast<Date>(*runtime("1-Jan-3000"));
+        CHECK_THROWS(far.timePoint());
+    }
+
+    SECTION("bad zone")
+    {
+        CHECK_THROWS(Date (epoch, minutes {7}));
+    }
+
+    SECTION("bulk")
+    {
+        std::vector<system_clock::time_point> times {
+            epoch, epoch + hours {36}, epoch + seconds {1500000000}
+        };
+
+        Block dates = Date::blockOf(times, minutes {-300});
+        CHECK(dates.length() == 3);
+        CHECK(mold(dates[2]).text == "2-Jan-1970/7:00-5:00");
+
+        CHECK(Date::timePoints(dates) == times);
+    }
+}
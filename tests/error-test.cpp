@@ -0,0 +1,52 @@
+#include <string>
+
+#include "rencpp/ren.hpp"
+
+using namespace ren;
+
+#include "catch.hpp"
+
+TEST_CASE("error test", "[rebol] [error]")
+{
+    SECTION("message with braces")
+    {
+        Error error ("Unbalanced } in {input");
+
+        CHECK(runtime("select", error, "'message")->isEqualTo(
+            String {"Unbalanced } in {input"}
+        ));
+        CHECK(runtime("select", error, "'id")->isEqualTo(Word {"message"}));
+    }
+
+    SECTION("id and fields")
+    {
+        Error error ("out-of-range", "Value too large", {{"limit", 255}});
+
+        CHECK(runtime("select", error, "'id")->isEqualTo(
+            Word {"out-of-range"}
+        ));
+        CHECK(runtime("select", error, "'limit")->isEqualTo(Integer {255}));
+    }
+
+    SECTION("raised from a function")
+    {
+        Function check = Function::construct(
+            "{Fails with an id} value [integer!]",
+            [](Integer const & value) -> Integer {
+                if (static_cast<int>(value) > 10)
+                    throw Error ("too-big", "Too big", {{"value", value}});
+                return value;
+            }
+        );
+
+        try {
+            check(20);
+            FAIL("Error wasn't raised");
+        }
+        catch (evaluation_error const & e) {
+            CHECK(runtime("select", e.error(), "'value")->isEqualTo(
+                Integer {20}
+            ));
+        }
+    }
+}
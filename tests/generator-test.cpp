@@ -0,0 +1,67 @@
+#include <cstdint>
+
+#include "rencpp/ren.hpp"
+
+using namespace ren;
+
+#include "catch.hpp"
+
+
+TEST_CASE("generator test", "[rebol] [generator]")
+{
+    SECTION("range-for")
+    {
+        Generator squares {Block {"repeat i 1000 [yield i * i]"}, 16};
+
+        int count = 0;
+        int64_t total = 0;
+        for (AnyValue value : squares) {
+            ++count;
+            total += static_cast<Integer>(value);
+        }
+
+        CHECK(count == 1000);
+        CHECK(total == 333833500);
+    }
+
+    SECTION("evaluating while paused")
+    {
+        Generator words {Block {"for-each w [a b c] [yield w]"}, 1};
+
+        int count = 0;
+        for (AnyValue word : words) {
+            CHECK(hasType<Word>(word));
+            CHECK(static_cast<Integer>(*runtime("1 + 2")) == 3);
+            ++count;
+        }
+        CHECK(count == 3);
+    }
+
+    SECTION("error after values")
+    {
+        Generator failing {Block {"yield 1 yield 2 fail {no more}"}};
+
+        CHECK(static_cast<Integer>(*failing.next()) == 1);
+        CHECK(static_cast<Integer>(*failing.next()) == 2);
+        CHECK_THROWS_AS(failing.next(), evaluation_error);
+        CHECK(!failing.next());
+    }
+
+    SECTION("stopping early")
+    {
+        {
+            Generator endless {Block {"forever [yield 1]"}, 4};
+
+            int count = 0;
+            for (AnyValue value : endless) {
+                if (++count == 10)
+                    break;
+            }
+            CHECK(count == 10);
+        }
+
+        // The halt that stopped the script doesn't linger
+
+        CHECK(static_cast<Integer>(*runtime("1 + 1")) == 2);
+    }
+}
@@ -0,0 +1,99 @@
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "rencpp/ren.hpp"
+
+using namespace ren;
+
+#include "catch.hpp"
+
+
+TEST_CASE("image test", "[rebol] [image]")
+{
+    // Two rows of five pixels, padded to a stride of six pixels.  That's
+    // enough for the four-at-a-time conversion and the pixel left after it.
+
+    unsigned char const rgba[] = {
+        255, 0, 0, 255,   0, 255, 0, 128,   0, 0, 255, 0,
+        1, 2, 3, 4,   200, 100, 50, 128,   9, 9, 9, 9,
+
+        10, 20, 30, 40,   50, 60, 70, 80,   90, 100, 110, 120,
+        130, 140, 150, 160,   170, 180, 190, 200,   9, 9, 9, 9
+    };
+
+    unsigned char const argb[] = {
+        255, 255, 0, 0,   128, 0, 255, 0,   0, 0, 0, 255,
+        4, 1, 2, 3,   128, 200, 100, 50,
+
+        40, 10, 20, 30,   80, 50, 60, 70,   120, 90, 100, 110,
+        160, 130, 140, 150,   200, 170, 180, 190
+    };
+
+    ConstPixelSpan source {rgba, 5, 2, 24, ChannelOrder::RGBA};
+
+    SECTION("swizzle")
+    {
+        unsigned char out[5 * 2 * 4];
+        convertPixels(source, PixelSpan {out, 5, 2, 20, ChannelOrder::ARGB});
+        CHECK(memcmp(out, argb, sizeof(argb)) == 0);
+    }
+
+    SECTION("in place")
+    {
+        unsigned char pixels[sizeof(rgba)];
+        memcpy(pixels, rgba, sizeof(rgba));
+
+        convertPixels(
+            ConstPixelSpan {pixels, 5, 2, 24, ChannelOrder::RGBA},
+            PixelSpan {pixels, 5, 2, 24, ChannelOrder::ARGB}
+        );
+        CHECK(memcmp(pixels, argb, 20) == 0);
+        CHECK(memcmp(pixels + 24, argb + 20, 20) == 0);
+
+        // Overlapping any other way would read pixels already overwritten
+
+        CHECK_THROWS(convertPixels(
+            ConstPixelSpan {pixels, 5, 2, 24, ChannelOrder::ARGB},
+            PixelSpan {pixels, 5, 2, 20, ChannelOrder::RGBA}
+        ));
+        CHECK_THROWS(convertPixels(
+            ConstPixelSpan {pixels, 4, 2, 24, ChannelOrder::ARGB},
+            PixelSpan {pixels + 4, 4, 2, 24, ChannelOrder::RGBA}
+        ));
+    }
+
+    SECTION("premultiply")
+    {
+        unsigned char pm[5 * 2 * 4];
+        convertPixels(
+            source, PixelSpan {pm, 5, 2, 20, ChannelOrder::RGBA, true}
+        );
+
+        CHECK(pm[0] == 255); // opaque red stays red
+        CHECK(pm[5] == 128); // green at half alpha is halved
+        CHECK(pm[7] == 128); // ...but alpha itself is kept
+        CHECK(pm[10] == 0); // transparent blue goes to zero
+
+        CHECK(pm[16] == 100); // the last pixel is converted on its own
+        CHECK(pm[17] == 50);
+        CHECK(pm[19] == 128);
+    }
+
+    SECTION("image round trip")
+    {
+        Image image {source};
+        CHECK(image.width() == 5);
+        CHECK(image.height() == 2);
+
+        ConstPixelSpan native = image.pixels();
+        CHECK(native.order == Image::nativeOrder);
+        CHECK(native.data[0] == 0); // blue byte of opaque red
+        CHECK(native.data[2] == 255); // red byte
+
+        unsigned char back[5 * 2 * 4];
+        image.readPixels(PixelSpan {back, 5, 2, 20, ChannelOrder::RGBA});
+        CHECK(memcmp(back, rgba, 20) == 0);
+        CHECK(memcmp(back + 20, rgba + 24, 20) == 0);
+    }
+}
@@ -64,3 +64,43 @@ TEST_CASE("iteration tests", "[rebol] [iterator]")
 }
 
 
+TEST_CASE("codepoint iteration tests", "[rebol] [iterator]")
+{
+    SECTION("ascii")
+    {
+        String text {"Hello^/World"};
+
+        std::u32string decoded;
+        for (char32_t c : text.codepoints())
+            decoded.push_back(c);
+
+        CHECK(decoded == U"Hello\nWorld");
+    }
+
+    SECTION("unicode")
+    {
+        String text {u8"Met\u00C6ducation \u4E2D"};
+
+        std::u32string decoded;
+        text.decodeInto(decoded);
+
+        CHECK(decoded == U"Met\u00C6ducation \u4E2D");
+    }
+
+    SECTION("from the string's position")
+    {
+        // Skip further than one SSE2 step, to check the offset is used
+        //
+        String text = static_cast<String>(*runtime(
+            "skip", String {"abcdefghijklmnopqrstuvwxyz0123456789"}, 30
+        ));
+
+        std::u32string decoded {U"previous contents"};
+        text.decodeInto(decoded);
+        CHECK(decoded == U"456789");
+
+        auto range = text.codepoints();
+        CHECK(*range.begin() == U'4');
+        CHECK(std::distance(range.begin(), range.end()) == 6);
+    }
+}
@@ -0,0 +1,109 @@
+#include <string>
+#include <vector>
+
+#include "rencpp/ren.hpp"
+
+using namespace ren;
+
+#include "catch.hpp"
+
+
+namespace {
+
+struct Point {
+    int x;
+    int y;
+};
+
+struct Quote {
+    std::string symbol;
+    double last_trade;
+    bool halted;
+    Point where;
+    std::vector<int> history;
+    std::vector<bool> flags;
+    optional<std::string> note;
+};
+
+} // end anonymous namespace
+
+RENCPP_MARSHAL(Point, x, y)
+RENCPP_MARSHAL(
+    Quote, symbol, last_trade, halted, where, history, flags, note
+)
+
+
+TEST_CASE("marshal test", "[rebol] [marshal]")
+{
+    Quote quote;
+    quote.symbol = "IBM";
+    quote.last_trade = 10.5;
+    quote.halted = false;
+    quote.where = Point {10, 20};
+    quote.history = {1, 2, 3};
+    quote.flags = {true, false, true};
+
+    SECTION("object round trip")
+    {
+        Object obj = toObject(quote);
+
+        CHECK(runtime("select", obj, LitWord {"symbol"})->isEqualTo(
+            String {"IBM"}
+        ));
+        CHECK(runtime("select", obj, LitWord {"last-trade"})->isEqualTo(
+            Float {10.5}
+        ));
+
+        Quote back = fromObject<Quote>(obj);
+        CHECK(back.symbol == "IBM");
+        CHECK(back.last_trade == 10.5);
+        CHECK(back.halted == false);
+        CHECK(back.where.x == 10);
+        CHECK(back.where.y == 20);
+        CHECK(back.history == std::vector<int> {1, 2, 3});
+        CHECK(back.flags == std::vector<bool> {true, false, true});
+        CHECK(back.note == nullopt);
+    }
+
+    SECTION("object made by the evaluator")
+    {
+        auto obj = static_cast<Object>(*runtime(
+            "make object! [y: 4 unrelated: 5 x: 3]"
+        ));
+
+        Point point = fromObject<Point>(obj);
+        CHECK(point.x == 3);
+        CHECK(point.y == 4);
+    }
+
+    SECTION("positional block")
+    {
+        Block row = toBlock(Point {1, 2});
+        CHECK(row.isEqualTo(Block {1, 2}));
+
+        Point point = fromBlock<Point>(Block {3, 4});
+        CHECK(point.x == 3);
+        CHECK(point.y == 4);
+    }
+
+    SECTION("batch")
+    {
+        std::vector<Point> points {{1, 2}, {3, 4}, {5, 6}};
+
+        Block block = toObjects(points);
+        CHECK(block.length() == 3);
+
+        auto back = fromObjects<Point>(block);
+        REQUIRE(back.size() == 3);
+        CHECK(back[2].x == 5);
+        CHECK(back[2].y == 6);
+    }
+
+    SECTION("wrong type")
+    {
+        auto obj = static_cast<Object>(*runtime(
+            "make object! [x: 1 y: {two}]"
+        ));
+        CHECK_THROWS_AS(fromObject<Point>(obj), bad_value_cast);
+    }
+}
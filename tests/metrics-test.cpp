@@ -0,0 +1,76 @@
+#include <string>
+
+#include "rencpp/ren.hpp"
+
+using namespace ren;
+
+#include "catch.hpp"
+
+
+TEST_CASE("metrics test", "[rebol] [metrics]")
+{
+    SECTION("built-in counts")
+    {
+        uint64_t evaluations = metrics.evaluations.get();
+        uint64_t scanned = metrics.scannedBytes.get();
+        uint64_t calls = metrics.nativeCalls.get();
+        int64_t roots = metrics.liveRoots.get();
+
+        auto twice = Function::construct(
+            "n [integer!]",
+            [](Integer const & n) -> Integer {
+                return static_cast<int>(n) * 2;
+            }
+        );
+
+        {
+            AnyValue result = *runtime("1 + 2");
+            CHECK(metrics.liveRoots.get() > roots);
+            CHECK(metrics.evaluations.get() > evaluations);
+            CHECK(metrics.scannedBytes.get() >= scanned + 5);
+
+            twice(10);
+            CHECK(metrics.nativeCalls.get() == calls + 1);
+        }
+
+        CHECK(metrics.applySeconds.snapshot().count() > 0);
+    }
+
+    SECTION("registered metrics")
+    {
+        Counter & requests = metrics.counter("test_requests", "Requests");
+        requests.add(3);
+
+        // The same name gives back the same counter
+        //
+        CHECK(&metrics.counter("test_requests", "Requests") == &requests);
+        CHECK_THROWS(metrics.gauge("test_requests", "Not a counter"));
+        CHECK_THROWS(metrics.counter("test-requests", "Bad name"));
+
+        Histogram & sizes = metrics.histogram(
+            "test_sizes", "Sizes\nin bytes", {10, 100}
+        );
+        sizes.observe(5);
+        sizes.observe(50);
+        sizes.observe(500);
+
+        std::string text = metrics.openMetrics();
+
+        CHECK(text.find("# TYPE ren_evaluations counter\n")
+            != std::string::npos);
+        CHECK(text.find("ren_gc_cycles_total ") != std::string::npos);
+        CHECK(text.find("test_requests_total 3\n") != std::string::npos);
+        CHECK(text.find("# HELP test_sizes Sizes\\nin bytes\n")
+            != std::string::npos);
+        CHECK(text.find(
+            "test_sizes_bucket{le=\"10\"} 1\n"
+            "test_sizes_bucket{le=\"100\"} 2\n"
+            "test_sizes_bucket{le=\"+Inf\"} 3\n"
+            "test_sizes_count 3\n"
+            "test_sizes_sum 555\n"
+        ) != std::string::npos);
+
+        CHECK(text.size() >= 6);
+        CHECK(text.substr(text.size() - 6) == "# EOF\n");
+    }
+}
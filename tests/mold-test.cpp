@@ -0,0 +1,94 @@
+#include <string>
+
+#include "rencpp/ren.hpp"
+
+using namespace ren;
+
+#include "catch.hpp"
+
+
+TEST_CASE("bounded mold test", "[rebol] [mold]")
+{
+    SECTION("unlimited")
+    {
+        Block block {1, 2, Block {3, 4}, "{five}"};
+
+        Molded molded = mold(block);
+        CHECK(molded.text == "[1 2 [3 4] \"five\"]");
+        CHECK(!molded.truncated);
+    }
+
+    SECTION("byte limit")
+    {
+        AnyValue numbers = *runtime("array/initial 100000 1020");
+
+        MoldLimits limits;
+        limits.maxBytes = 12;
+
+        Molded molded = mold(numbers, limits);
+        CHECK(molded.text == "[1020 1020 1...");
+        CHECK(molded.truncated);
+    }
+
+    SECTION("byte limit on a long string")
+    {
+        AnyValue text = *runtime("append/dup copy {} {x} 100000");
+
+        MoldLimits limits;
+        limits.maxBytes = 4;
+        limits.ellipsis = "~";
+
+        Molded molded = mold(text, limits);
+        CHECK(molded.text == "\"xxx~");
+        CHECK(molded.truncated);
+    }
+
+    SECTION("element limit")
+    {
+        Block block {1, 2, Block {3, 4, 5}, 6};
+
+        MoldLimits limits;
+        limits.maxElements = 6; // counting the blocks
+
+        Molded molded = mold(block, limits);
+        CHECK(molded.text == "[1 2 [3 4 ...]]");
+        CHECK(molded.truncated);
+    }
+
+    SECTION("depth limit")
+    {
+        Block block {1, Block {2, Group {3}}, 4};
+
+        MoldLimits limits;
+        limits.maxDepth = 2;
+
+        Molded molded = mold(block, limits);
+        CHECK(molded.text == "[1 [2 (...)] 4]");
+        CHECK(molded.truncated);
+    }
+
+    SECTION("cycles")
+    {
+        AnyValue cyclic = *runtime("b: copy [1] append/only b b");
+
+        Molded molded = mold(cyclic);
+        CHECK(molded.text == "[1 [...]]");
+    }
+
+    SECTION("paging")
+    {
+        AnyArray numbers = static_cast<AnyArray>(
+            *runtime("collect [repeat i 2000 [keep i]]")
+        );
+
+        Molded page = moldRange(numbers, 1000, 3);
+        CHECK(page.text == "1001 1002 1003");
+        CHECK(!page.truncated);
+
+        Molded last = moldRange(numbers, 1999, 100);
+        CHECK(last.text == "2000");
+
+        Molded past = moldRange(numbers, 5000, 100);
+        CHECK(past.text.empty());
+    }
+}
@@ -0,0 +1,202 @@
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rencpp/ren.hpp"
+
+using namespace ren;
+
+#include "catch.hpp"
+
+
+TEST_CASE("parse test", "[rebol] [parse]")
+{
+    SECTION("borrowed string input")
+    {
+        std::string data {"Hello [Ren C++ Binding] World!"};
+
+        BorrowedString text {data};
+        CHECK(text.isBorrowed());
+
+        Word variable {"foo"};
+
+        Block rule {
+            "thru {[}",
+            "copy", variable, "to {]}",
+            "to end"
+        };
+
+        CHECK(static_cast<bool>(
+            static_cast<Logic>(*runtime("parse", text, rule))
+        ));
+        CHECK(variable()->isEqualTo(String {"Ren C++ Binding"}));
+    }
+
+    SECTION("borrowed string is read-only")
+    {
+        std::string data {"abc"};
+        BorrowedString text {data};
+
+        CHECK_THROWS_AS(runtime("append", text, "{d}"), evaluation_error);
+
+        runtime("unprotect", text);
+        CHECK_THROWS_AS(runtime("append", text, "{d}"), evaluation_error);
+        CHECK(data == "abc");
+    }
+
+    SECTION("unterminated input is copied")
+    {
+        char data[] = {'a', 'b', 'c', 'd'}; // no NUL after the first three
+
+        BorrowedString copied {data, 3};
+        CHECK(!copied.isBorrowed());
+        CHECK(static_cast<std::string>(copied) == "abc");
+
+        BorrowedString borrowed {
+            "abc", 3, BorrowedString::Terminator::Present
+        };
+        CHECK(borrowed.isBorrowed());
+    }
+
+    SECTION("non-ASCII input is copied")
+    {
+        std::string data {"caf\xC3\xA9"};
+        BorrowedString text {data};
+
+        CHECK(!text.isBorrowed());
+        CHECK(static_cast<std::string>(text) == data);
+    }
+}
+
+
+TEST_CASE("parse rule test", "[rebol] [parse]")
+{
+    SECTION("matching")
+    {
+        runtime("digit: charset {0123456789}");
+
+        ParseRule number {Block {"some digit"}};
+
+        CHECK(number.matches(String {"1020"}));
+        CHECK(!number.matches(String {"10x20"}));
+        CHECK(!number.matches(String {""}));
+    }
+
+    SECTION("sub-rules are resolved once")
+    {
+        runtime("letters: [some {a}]");
+
+        ParseRule rule {Block {"letters {b}"}};
+
+        // Rebinding the variable doesn't affect the prebuilt rule
+        //
+        runtime("letters: [some {z}]");
+
+        CHECK(rule.matches(String {"aab"}));
+        CHECK(!rule.matches(String {"zzb"}));
+
+        CHECK(runtime("parse {zzb} [letters {b}]")->isEqualTo(Logic {true}));
+    }
+
+    SECTION("set and copy targets are not resolved")
+    {
+        Word variable {"target"};
+        runtime("target: {unchanged}");
+
+        ParseRule rule {Block {"thru {[}", "copy", variable, "to {]} to end"}};
+
+        CHECK(rule.matches(String {"Hello [Ren C++ Binding] World!"}));
+        CHECK(variable()->isEqualTo(String {"Ren C++ Binding"}));
+    }
+
+    SECTION("mark and seek targets are not resolved")
+    {
+        // Holding a series, as it would after an earlier match
+        //
+        Word position {"position"};
+        runtime("position: {stale}");
+
+        ParseRule rule {Block {
+            "thru {b} mark", position, "seek", position, "{c} end"
+        }};
+
+        CHECK(rule.matches(String {"abc"}));
+        CHECK(rule.matches(String {"xxbc"}));
+        CHECK(runtime("position = {c}")->isTruthy());
+
+        CHECK(!rule.matches(String {"abd"}));
+    }
+
+    SECTION("recursive rule")
+    {
+        runtime("nested: [{(} any nested {)}]");
+
+        ParseRule rule {Block {"nested"}};
+
+        CHECK(rule.matches(String {"(()(()))"}));
+        CHECK(!rule.matches(String {"(()"}));
+    }
+
+    SECTION("unbound word")
+    {
+        AnyValue unbound = *runtime("unbind 'no-such-rule");
+
+        Block rule {"some", unbound};
+        CHECK_THROWS_AS(ParseRule (rule), evaluation_error);
+    }
+}
+
+
+TEST_CASE("parse action test", "[rebol] [parse]")
+{
+    runtime("letter: charset [#\"a\" - #\"z\"]");
+
+    std::string data {"one, two three"};
+
+    std::vector<std::pair<size_t, size_t>> spans;
+
+    ParseRule tokenizer {Block {
+        "some [",
+            ParseRule::action(
+                Block {"some letter"},
+                [&](AnySeries const & input, size_t start, size_t end) {
+                    CHECK(input.index() == start);
+                    spans.emplace_back(start, end);
+                }
+            ),
+            "| skip",
+        "]"
+    }};
+
+    CHECK(tokenizer.matches(BorrowedString {data}));
+
+    std::vector<std::string> words;
+    for (auto & span : spans)
+        words.push_back(data.substr(span.first, span.second - span.first));
+
+    CHECK(words == (std::vector<std::string> {"one", "two", "three"}));
+
+    // The rule can be run again, and the action fires again
+    //
+    spans.clear();
+    CHECK(tokenizer.matches(String {"four"}));
+    CHECK(spans.size() == 1);
+
+    // An action used again inside its own sub-rule keeps the outer match's
+    // start (and the failed attempts at `)` don't disturb it)
+    //
+    spans.clear();
+    runtime("nested:", ParseRule::action(
+        Block {"{(} any nested {)}"},
+        [&](AnySeries const &, size_t start, size_t end) {
+            spans.emplace_back(start, end);
+        }
+    ));
+
+    ParseRule parens {Block {"nested"}};
+    CHECK(parens.matches(String {"(()(()))"}));
+
+    CHECK(spans == (std::vector<std::pair<size_t, size_t>> {
+        {1, 3}, {4, 6}, {3, 7}, {0, 8}
+    }));
+}
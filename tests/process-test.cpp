@@ -0,0 +1,90 @@
+#include <string>
+#include <vector>
+
+#include "rencpp/ren.hpp"
+
+using namespace ren;
+
+#include "catch.hpp"
+
+
+TEST_CASE("subprocess test", "[rebol] [process]")
+{
+    SECTION("capture")
+    {
+        auto captured = Subprocess::capture(
+            {"/bin/sh", "-c", "printf out; printf err >&2; exit 3"}
+        );
+
+        CHECK(captured.status == 3);
+        CHECK(captured.output == "out");
+        CHECK(captured.error == "err");
+    }
+
+    SECTION("input")
+    {
+        std::string big (1000000, 'x'); // more than a pipe holds
+
+        auto captured = Subprocess::capture({"cat"}, big);
+
+        CHECK(captured.status == 0);
+        CHECK(captured.output == big);
+    }
+
+    SECTION("streaming")
+    {
+        std::vector<std::string> chunks;
+
+        int status = Subprocess::run(
+            {"/bin/sh", "-c", "echo one; sleep 0.1; echo two"},
+            [&](Subprocess::Channel, char const * data, size_t size) {
+                chunks.emplace_back(data, size);
+            }
+        );
+
+        CHECK(status == 0);
+        CHECK(chunks.size() >= 2); // the sleep separates them
+
+        std::string joined;
+        for (auto const & chunk : chunks)
+            joined += chunk;
+        CHECK(joined == "one\ntwo\n");
+    }
+
+    SECTION("signal")
+    {
+        auto captured = Subprocess::capture({"/bin/sh", "-c", "kill -9 $$"});
+        CHECK(captured.status == 128 + 9);
+    }
+
+    SECTION("missing program")
+    {
+        CHECK_THROWS(Subprocess::capture({"no-such-program-for-rencpp"}));
+    }
+
+    SECTION("script function")
+    {
+        runtime("call-process: quote", Subprocess::function());
+
+        AnyValue status = *runtime(
+            "out: copy {}",
+            "err: copy #{}",
+            "call-process/input/output/error",
+                "[{/bin/sh} {-c} {cat; printf 'é' >&2}] {héllo} out err"
+        );
+
+        CHECK(status.isEqualTo(Integer {0}));
+        CHECK(runtime("out = {héllo}")->isTruthy());
+        CHECK(runtime("err = #{C3A9}")->isTruthy());
+
+        // Binary input is passed through as bytes
+        //
+        status = *runtime(
+            "out: copy #{}",
+            "call-process/input/output [{cat}] #{00FF48} out"
+        );
+
+        CHECK(status.isEqualTo(Integer {0}));
+        CHECK(runtime("out = #{00FF48}")->isTruthy());
+    }
+}
@@ -0,0 +1,59 @@
+#include <iostream>
+#include <string>
+
+#include "rencpp/ren.hpp"
+
+using namespace ren;
+
+#include "catch.hpp"
+
+TEST_CASE("profiler test", "[rebol] [profiler]")
+{
+    auto busy = Function::construct(
+        " {Spin in C++ so the profiler has something to see}"
+        " n [integer!]",
+
+        [](Integer const & n) -> Integer {
+            volatile int total = 0;
+            for (int i = 0; i < static_cast<int>(n) * 1000; ++i)
+                total += i;
+            return static_cast<int>(total);
+        }
+    );
+
+    runtime("profiled-busy: quote", busy);
+
+    profiler.reset();
+    profiler.start(std::chrono::microseconds {1000});
+    CHECK(profiler.isRunning());
+
+    // Long enough (a fraction of a second) to be sure of many samples
+    //
+    runtime("loop 2000 [profiled-busy 100]");
+
+    profiler.stop();
+    CHECK(!profiler.isRunning());
+
+    REQUIRE(profiler.sampleCount() != 0);
+
+    // Every line of output must be `stack count`, with stacks root first
+
+    std::string folded = profiler.folded();
+    size_t start = 0;
+    while (start < folded.size()) {
+        size_t end = folded.find('\n', start);
+        REQUIRE(end != std::string::npos);
+
+        std::string line = folded.substr(start, end - start);
+        size_t space = line.rfind(' ');
+        REQUIRE(space != std::string::npos);
+        CHECK(std::stoul(line.substr(space + 1)) > 0);
+
+        start = end + 1;
+    }
+
+    CHECK(folded.find("profiled-busy [c++]") != std::string::npos);
+
+    profiler.reset();
+    CHECK(profiler.folded().empty());
+}
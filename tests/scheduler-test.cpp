@@ -0,0 +1,90 @@
+#include <chrono>
+#include <thread>
+
+#include "rencpp/ren.hpp"
+
+using namespace ren;
+
+#include "catch.hpp"
+
+
+TEST_CASE("scheduler test", "[rebol] [scheduler]")
+{
+    Scheduler scheduler;
+    runtime("checkpoint: quote", scheduler.checkpoint);
+
+    SECTION("priorities")
+    {
+        runtime("log: copy []");
+
+        scheduler.submit("append log 'background", Scheduler::Background);
+        scheduler.submit("append log 'normal-1");
+        scheduler.submit("append log 'interactive", Scheduler::Interactive);
+        scheduler.submit("append log 'normal-2");
+
+        scheduler.runPending();
+
+        CHECK(runtime(
+            "log = [interactive normal-1 normal-2 background]"
+        )->isTruthy());
+    }
+
+    SECTION("results")
+    {
+        Task sum = scheduler.submit("1 + 2");
+        Task failing = scheduler.submit("fail {oops}");
+        Task throwing = scheduler.submit("throw 10");
+
+        CHECK(sum.await() == Task::Status::Completed);
+        CHECK(static_cast<Integer>(*sum.result().value) == 3);
+
+        CHECK(failing.await() == Task::Status::Errored);
+        CHECK(failing.result().error);
+
+        CHECK(throwing.await() == Task::Status::Thrown);
+        CHECK(static_cast<Integer>(*throwing.result().value) == 10);
+    }
+
+    SECTION("interrupting")
+    {
+        runtime("log: copy []");
+
+        runtime("submit-quick: quote", Function::construct(
+            "{Submit a task more urgent than the caller}",
+            [&scheduler]() -> optional<AnyValue> {
+                scheduler.submit(
+                    "append log 'quick", Scheduler::Interactive
+                );
+                return nullopt;
+            }
+        ));
+
+        Task slow = scheduler.submit(
+            "append log 'start submit-quick loop 100 [checkpoint]"
+            " append log 'end"
+        );
+
+        CHECK(slow.await() == Task::Status::Completed);
+        CHECK(runtime("log = [start quick end]")->isTruthy());
+    }
+
+    SECTION("cancelling")
+    {
+        Task waiting = scheduler.submit("1 + 2");
+        waiting.cancel();
+        CHECK(waiting.poll() == Task::Status::Cancelled);
+        CHECK(waiting.result().status == Evaluation::Status::Halted);
+
+        Task endless = scheduler.submit("forever [checkpoint]");
+
+        std::thread canceller {[&endless]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds {50});
+            endless.cancel();
+        }};
+
+        CHECK(endless.await() == Task::Status::Cancelled);
+        canceller.join();
+
+        CHECK(static_cast<Integer>(*runtime("1 + 2")) == 3);
+    }
+}
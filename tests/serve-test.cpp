@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "catch.hpp"
+
+
+// ren-serve is run as a separate process, whose path CMake passes in as
+// REN_SERVE_PATH, and spoken to over its socket as any client would
+
+namespace {
+
+std::string frame(uint32_t id, std::string const & script) {
+    std::string out;
+    uint32_t length = static_cast<uint32_t>(script.size()) + 4;
+    for (uint32_t value : {length, id})
+        for (int shift = 24; shift >= 0; shift -= 8)
+            out += static_cast<char>((value >> shift) & 0xFF);
+    return out + script;
+}
+
+
+uint32_t getU32(std::string const & data, size_t at) {
+    uint32_t value = 0;
+    for (size_t n = 0; n < 4; ++n)
+        value = (value << 8) | static_cast<unsigned char>(data[at + n]);
+    return value;
+}
+
+
+bool readAll(int fd, std::string & data, size_t size) {
+    char chunk[4096];
+    while (data.size() < size) {
+        size_t wanted = std::min(sizeof(chunk), size - data.size());
+        ssize_t got = read(fd, chunk, wanted);
+        if (got > 0)
+            data.append(chunk, static_cast<size_t>(got));
+        else if (got == 0 || errno != EINTR)
+            return false;
+    }
+    return true;
+}
+
+
+struct Response {
+    uint32_t id;
+    int status;
+    std::string output;
+    int tag;
+    std::string value;
+};
+
+
+bool readResponse(int fd, Response & response) {
+    std::string header;
+    if (!readAll(fd, header, 4))
+        return false;
+
+    std::string body;
+    if (!readAll(fd, body, getU32(header, 0)))
+        return false;
+
+    if (body.size() < 11)
+        return false;
+
+    response.id = getU32(body, 0);
+    response.status = static_cast<unsigned char>(body[4]);
+    size_t outputSize = getU32(body, 6);
+    if (body.size() < 11 + outputSize)
+        return false;
+
+    response.output = body.substr(10, outputSize);
+    response.tag = static_cast<unsigned char>(body[10 + outputSize]);
+    response.value = body.substr(11 + outputSize);
+    return true;
+}
+
+
+int connectTo(std::string const & path) {
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    path.copy(address.sun_path, sizeof(address.sun_path) - 1);
+
+    // The server takes a moment to start listening
+
+    sockaddr * generic = reinterpret_cast<sockaddr *>(&address);
+
+    for (int tries = 0; tries < 100; ++tries) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (connect(fd, generic, sizeof(address)) == 0)
+            return fd;
+        close(fd);
+        std::this_thread::sleep_for(std::chrono::milliseconds {50});
+    }
+    return -1;
+}
+
+
+// Stopped however the test case is left (a failed REQUIRE throws)
+//
+struct Server {
+    pid_t pid;
+    int fd;
+
+    Server () : pid (-1), fd (-1) {}
+
+    ~Server () {
+        if (fd != -1)
+            close(fd);
+        if (pid > 0) {
+            kill(pid, SIGTERM);
+            waitpid(pid, nullptr, 0);
+        }
+    }
+};
+
+} // end anonymous namespace
+
+
+TEST_CASE("ren-serve test", "[rebol] [serve]")
+{
+    std::string path = "/tmp/ren-serve-test-" + std::to_string(getpid());
+
+    Server server;
+    server.pid = fork();
+    REQUIRE(server.pid != -1);
+    if (server.pid == 0) {
+        execl(
+            REN_SERVE_PATH, REN_SERVE_PATH,
+            "--socket", path.c_str(), "--workers", "1", "--timeout", "5",
+            static_cast<char *>(nullptr)
+        );
+        _exit(127);
+    }
+
+    server.fd = connectTo(path);
+    REQUIRE(server.fd != -1);
+
+    int fd = server.fd;
+
+    SECTION("pipelined requests")
+    {
+        std::string requests = frame(1, "1 + 2")
+            + frame(2, "42") // a single value, which LOAD would unwrap
+            + frame(3, "print {hi} true")
+            + frame(4, "fail {oops}");
+        CHECK(write(fd, requests.data(), requests.size())
+            == static_cast<ssize_t>(requests.size()));
+
+        Response response;
+
+        REQUIRE(readResponse(fd, response));
+        CHECK(response.id == 1);
+        CHECK(response.status == 0);
+        CHECK(response.tag == 4);
+        CHECK(response.value == "3");
+
+        REQUIRE(readResponse(fd, response));
+        CHECK(response.id == 2);
+        CHECK(response.status == 0);
+        CHECK(response.value == "42");
+
+        REQUIRE(readResponse(fd, response));
+        CHECK(response.id == 3);
+        CHECK(response.output == "hi\n");
+        CHECK(response.tag == 3);
+
+        REQUIRE(readResponse(fd, response));
+        CHECK(response.id == 4);
+        CHECK(response.status == 2);
+        CHECK(response.tag == 6);
+    }
+
+    SECTION("bad request")
+    {
+        std::string tooShort {"\0\0\0\2xx", 6};
+        CHECK(write(fd, tooShort.data(), tooShort.size()) == 6);
+
+        Response response;
+        REQUIRE(readResponse(fd, response));
+        CHECK(response.status == 4);
+
+        char byte;
+        CHECK(read(fd, &byte, 1) == 0); // then the connection is closed
+    }
+}
@@ -0,0 +1,114 @@
+#include <string>
+
+#include "rencpp/ren.hpp"
+
+using namespace ren;
+
+#include "catch.hpp"
+
+
+TEST_CASE("string search test", "[rebol] [strings]")
+{
+    String text {"The quick brown fox jumps over the lazy dog"};
+
+    SECTION("find")
+    {
+        CHECK(*text.find("quick") == 4);
+        CHECK(*text.find(String {"the"}) == 31);
+        CHECK(!text.find("Quick"));
+        CHECK(*text.find("o", 13) == 17);
+        CHECK(!text.find("dog", 41));
+        CHECK(*text.find("") == 0);
+    }
+
+    SECTION("find caseless")
+    {
+        CHECK(*text.findCaseless("QUICK") == 4);
+        CHECK(*text.findCaseless("the", 1) == 31);
+        CHECK(!text.findCaseless("cat"));
+    }
+
+    SECTION("wide characters")
+    {
+        String wide {"Ünïcödé text with 中文 in it"};
+
+        CHECK(*wide.find("中文") == 18);
+        CHECK(*wide.findCaseless("üNÏCÖDÉ") == 0);
+        CHECK(!wide.find("日本"));
+    }
+
+    SECTION("find from a position")
+    {
+        AnyString tail = text;
+        for (int i = 0; i < 10; ++i)
+            ++tail; // "brown fox..."
+
+        CHECK(*tail.find("fox") == 6);
+        CHECK(!tail.find("quick"));
+    }
+
+    SECTION("caseless equality")
+    {
+        String hello {"Hello World, longer than sixteen characters"};
+
+        CHECK(hello.isEqualToCaseless("hello world, LONGER than sixteen "
+            "characters"));
+        CHECK(hello.isEqualToCaseless(
+            String {"HELLO WORLD, LONGER THAN SIXTEEN CHARACTERS"}
+        ));
+        CHECK(!hello.isEqualToCaseless("Hello World"));
+        CHECK(!hello.isEqualToCaseless("Hello World, longer than sixteen "
+            "characterz"));
+
+        CHECK(String {"Straße"}.isEqualToCaseless("STRAßE"));
+    }
+}
+
+
+TEST_CASE("string split test", "[rebol] [strings]")
+{
+    SECTION("split")
+    {
+        Block pieces = String {"a,bc,,d"}.split(',');
+
+        REQUIRE(pieces.length() == 4);
+        CHECK(static_cast<String>(pieces[1]).isEqualTo("a"));
+        CHECK(static_cast<String>(pieces[2]).isEqualTo("bc"));
+        CHECK(static_cast<String>(pieces[3]).isEqualTo(""));
+        CHECK(static_cast<String>(pieces[4]).isEqualTo("d"));
+    }
+
+    SECTION("trailing delimiter")
+    {
+        Block pieces = String {"x|"}.split('|');
+
+        REQUIRE(pieces.length() == 2);
+        CHECK(static_cast<String>(pieces[2]).isEqualTo(""));
+    }
+
+    SECTION("no delimiter")
+    {
+        Block pieces = String {"no delimiters here"}.split(U'中');
+
+        REQUIRE(pieces.length() == 1);
+        CHECK(static_cast<String>(pieces[1]).isEqualTo("no delimiters here"));
+    }
+
+    SECTION("from scripts")
+    {
+        runtime(
+            "find-text: quote", AnyString::findFunction(),
+            "split-text: quote", AnyString::splitFunction()
+        );
+
+        CHECK(runtime(
+            "{quick fox} = find-text {The quick fox} {QUICK}"
+        )->isTruthy());
+        CHECK(runtime(
+            "blank? find-text/case {The quick fox} {QUICK}"
+        )->isTruthy());
+        CHECK(runtime(
+            "[{a} {bc} {}] = split-text {a,bc,} #\",\""
+        )->isTruthy());
+    }
+}
@@ -0,0 +1,82 @@
+#include <string>
+
+#include "rencpp/ren.hpp"
+
+using namespace ren;
+
+#include "catch.hpp"
+
+
+namespace {
+
+std::string classify(AnyValue const & value) {
+    return visit(value, overloaded(
+        [](Integer const & i) {
+            return "integer " + std::to_string(static_cast<int>(i));
+        },
+        [](Float const &) { return std::string {"float"}; },
+        [](Word const &) { return std::string {"word"}; },
+        [](AnyWord const &) { return std::string {"any-word"}; },
+        [](Block const & b) {
+            return "block " + std::to_string(b.length());
+        },
+        [](AnyString const &) { return std::string {"any-string"}; },
+        [](AnyValue const &) { return std::string {"other"}; }
+    ));
+}
+
+} // end anonymous namespace
+
+
+TEST_CASE("visit test", "[rebol] [visit]")
+{
+    SECTION("most specific handler is chosen")
+    {
+        CHECK(classify(Integer {1020}) == "integer 1020");
+        CHECK(classify(Float {10.20}) == "float");
+        CHECK(classify(Word {"foo"}) == "word");
+        CHECK(classify(Block {1, 2, 3}) == "block 3");
+    }
+
+    SECTION("base class handlers catch what has no closer match")
+    {
+        CHECK(classify(SetWord {"foo"}) == "any-word");
+        CHECK(classify(String {"hello"}) == "any-string");
+        CHECK(classify(Tag {"div"}) == "any-string");
+        CHECK(classify(AnyValue {true}) == "other");
+    }
+
+    SECTION("taking the parameter by value keeps a copy")
+    {
+        optional<Block> kept;
+
+        {
+            Block inner {"a", "b"};
+            AnyValue outer = inner;
+
+            visit(outer, overloaded(
+                [&](Block b) { kept = b; },
+                [](AnyValue const &) {}
+            ));
+        }
+
+        REQUIRE(kept != nullopt);
+        CHECK(kept->length() == 2);
+    }
+
+    SECTION("block elements")
+    {
+        Block block {1, "two", Word {"three"}, 4};
+
+        int sum = 0;
+        size_t others = 0;
+        for (auto item : block)
+            visit(item, overloaded(
+                [&](Integer const & i) { sum += static_cast<int>(i); },
+                [&](AnyValue const &) { ++others; }
+            ));
+
+        CHECK(sum == 5);
+        CHECK(others == 2);
+    }
+}
@@ -0,0 +1,869 @@
+//
+// ren-serve.cpp
+// This file is part of RenCpp
+// Copyright (C) 2015-2018 HostileFork.com
+//
+// Licensed under the Boost License, Version 1.0 (the "License")
+//
+//      http://www.boost.org/LICENSE_1_0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied.  See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// See http://rencpp.hostilefork.com for more information on this project
+//
+//=////////////////////////////////////////////////////////////////////////=//
+//
+// ren-serve keeps engines running behind a Unix domain socket, so programs
+// in other languages can evaluate scripts without linking RenCpp, and
+// without paying for an interpreter to start up on every request:
+//
+//     ren-serve --socket /tmp/ren.sock --workers 4 --timeout 10
+//
+// There is one engine per worker process (the runtime is one per process,
+// and not thread safe).  Each worker serves one connection at a time, so
+// `--workers` is how many connections are served at once; the others wait
+// to be accepted.  A worker that dies is replaced.
+//
+// All integers on the wire are unsigned and big-endian.  Each message in
+// either direction is a frame:
+//
+//     u32 length      of what follows
+//     ...             `length` bytes
+//
+// A request frame holds:
+//
+//     u32 id          chosen by the client, echoed in the response
+//     ...             the script, as UTF-8 source text
+//
+// A client may send any number of requests without waiting for responses.
+// They are evaluated in order, and responses come back in the same order:
+//
+//     u32 id
+//     u8  status      0 completed, 1 thrown, 2 error, 3 timed out,
+//                     4 bad request (then the connection is closed)
+//     u8  flags       1 if the output was cut, 2 if the value was cut
+//     u32 size        of the output
+//     ...             what the script wrote with PRINT etc. (UTF-8)
+//     u8  tag         how the rest of the frame encodes the value:
+//                         0  no value
+//                         1  BLANK!
+//                         2  #[false]
+//                         3  #[true]
+//                         4  INTEGER!, as decimal digits
+//                         5  DECIMAL!, as a u64 of its IEEE-754 bits
+//                         6  text (a STRING!, or the message of an error)
+//                         7  anything else, as its MOLD
+//
+// For a THROW the value is the one thrown.  For an error it is the error
+// FORMed, as text.  Output and values are cut to `--max-response` bytes.
+//
+// Each script runs with its set-words bound into a fresh object, so what
+// one request assigns is not seen by the next.  (A script can still change
+// shared state on purpose, e.g. by setting words in LIB.)
+//
+// Requests are bounded:
+//
+// * --timeout SECONDS - the evaluation is halted when it is up.  If the
+//   halt isn't noticed within the same time again (e.g. stuck in a native),
+//   the worker exits, which closes the connection.
+//
+// * --memory MB - the worker's address space is limited to this, so an
+//   evaluation that allocates past it fails with an out-of-memory error.
+//   As a worker runs one evaluation at a time, that is the bound on any
+//   one of them (plus what the engine itself takes).
+//
+// * --max-request BYTES - a larger frame is answered with status 4.
+//
+// * --idle SECONDS - a connection is closed if the client sends nothing for
+//   this long while a request is awaited (or is partly sent), or doesn't
+//   read responses for this long.  Otherwise idle clients could hold every
+//   worker.
+//
+// !!! Anyone who can connect to the socket can run code as this user.  It
+// is made readable and writable only by its owner; put it in a directory
+// with the access you want.
+//
+
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <thread>
+
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "rencpp/ren.hpp"
+
+using namespace ren;
+
+
+namespace {
+
+//
+// OPTIONS
+//
+
+struct Options {
+    std::string socketPath;
+    int workers = 4;
+    std::chrono::seconds timeout {10};
+    std::chrono::seconds idle {30};
+    size_t memoryMegabytes = 512;
+    size_t maxRequest = 16 * 1024 * 1024;
+    size_t maxResponse = 16 * 1024 * 1024;
+};
+
+
+char const usage[] =
+    "usage: ren-serve --socket PATH [--workers N] [--timeout SECONDS]\n"
+    "                 [--idle SECONDS] [--memory MB]\n"
+    "                 [--max-request BYTES] [--max-response BYTES]\n";
+
+
+size_t positive(char const * option, char const * text) {
+    char * end;
+    errno = 0;
+    unsigned long long number = std::strtoull(text, &end, 10);
+    if (*text == '\0' || *end != '\0' || errno != 0 || number == 0)
+        throw std::runtime_error(
+            std::string {option} + " needs a positive number"
+        );
+    return static_cast<size_t>(number);
+}
+
+
+Options parseOptions(int argc, char * argv[]) {
+    Options options;
+
+    for (int n = 1; n < argc; ++n) {
+        std::string option = argv[n];
+        if (n + 1 == argc)
+            throw std::runtime_error(option + " needs a value");
+        char const * value = argv[++n];
+
+        if (option == "--socket")
+            options.socketPath = value;
+        else if (option == "--workers")
+            options.workers = static_cast<int>(positive(argv[n - 1], value));
+        else if (option == "--timeout")
+            options.timeout = std::chrono::seconds {
+                static_cast<long>(positive(argv[n - 1], value))
+            };
+        else if (option == "--idle")
+            options.idle = std::chrono::seconds {
+                static_cast<long>(positive(argv[n - 1], value))
+            };
+        else if (option == "--memory")
+            options.memoryMegabytes = positive(argv[n - 1], value);
+        else if (option == "--max-request")
+            options.maxRequest = positive(argv[n - 1], value);
+        else if (option == "--max-response")
+            options.maxResponse = positive(argv[n - 1], value);
+        else
+            throw std::runtime_error("unknown option " + option);
+    }
+
+    if (options.socketPath.empty())
+        throw std::runtime_error("--socket is required");
+
+    return options;
+}
+
+
+
+//
+// WIRE FORMAT
+//
+
+enum class Status : unsigned char {
+    Completed = 0,
+    Thrown = 1,
+    Errored = 2,
+    TimedOut = 3,
+    BadRequest = 4
+};
+
+enum Flag : unsigned char {
+    OutputCut = 1,
+    ValueCut = 2
+};
+
+enum class Encoding : unsigned char {
+    None = 0,
+    Blank = 1,
+    False = 2,
+    True = 3,
+    Integer = 4,
+    Decimal = 5,
+    Text = 6,
+    Molded = 7
+};
+
+
+void putByte(std::string & out, unsigned char byte) {
+    out.push_back(static_cast<char>(byte));
+}
+
+
+void putU32(std::string & out, uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8)
+        putByte(out, static_cast<unsigned char>((value >> shift) & 0xFF));
+}
+
+
+uint32_t getU32(char const * data) {
+    uint32_t value = 0;
+    for (int n = 0; n < 4; ++n)
+        value = (value << 8) | static_cast<unsigned char>(data[n]);
+    return value;
+}
+
+
+// Cut at `limit` bytes, backing up so a UTF-8 sequence isn't split
+//
+bool cutUtf8(std::string & text, size_t limit) {
+    if (text.size() <= limit)
+        return false;
+
+    size_t cut = limit;
+    while (cut > 0 && (static_cast<unsigned char>(text[cut]) & 0xC0) == 0x80)
+        --cut;
+    text.resize(cut);
+    return true;
+}
+
+
+struct Encoded {
+    Encoding encoding;
+    std::string bytes;
+    bool cut;
+};
+
+
+Encoded encodeText(std::string text, size_t limit) {
+    bool cut = cutUtf8(text, limit);
+    return Encoded {Encoding::Text, std::move(text), cut};
+}
+
+
+Encoded encodeValue(optional<AnyValue> const & value, size_t limit) {
+    if (!value)
+        return Encoded {Encoding::None, std::string {}, false};
+
+    if (hasType<Blank>(*value))
+        return Encoded {Encoding::Blank, std::string {}, false};
+
+    if (hasType<Logic>(*value)) {
+        bool truth = static_cast<Logic>(*value);
+        Encoding encoding = truth ? Encoding::True : Encoding::False;
+        return Encoded {encoding, std::string {}, false};
+    }
+
+    if (hasType<Integer>(*value)) {
+        //
+        // FORM gives all 64 bits, where Integer only converts to an int
+        //
+        return Encoded {Encoding::Integer, to_string(*value), false};
+    }
+
+    if (hasType<Float>(*value)) {
+        double number = static_cast<Float>(*value);
+        uint64_t bits;
+        static_assert(sizeof(bits) == sizeof(number), "double isn't 64-bit");
+        std::memcpy(&bits, &number, sizeof(bits));
+
+        std::string bytes;
+        putU32(bytes, static_cast<uint32_t>(bits >> 32));
+        putU32(bytes, static_cast<uint32_t>(bits & 0xFFFFFFFF));
+        return Encoded {Encoding::Decimal, bytes, false};
+    }
+
+    if (hasType<String>(*value))
+        return encodeText(to_string(*value), limit);
+
+    MoldLimits limits;
+    limits.maxBytes = limit;
+    limits.ellipsis = "";
+    limits.all = true;
+
+    Molded molded = mold(*value, limits);
+    return Encoded {Encoding::Molded, molded.text, molded.truncated};
+}
+
+
+std::string responseFrame(
+    uint32_t id,
+    Status status,
+    std::string const & output,
+    bool outputCut,
+    Encoded const & value
+) {
+    std::string payload;
+    putU32(payload, id);
+    putByte(payload, static_cast<unsigned char>(status));
+    putByte(
+        payload,
+        static_cast<unsigned char>(
+            (outputCut ? OutputCut : 0) | (value.cut ? ValueCut : 0)
+        )
+    );
+    putU32(payload, static_cast<uint32_t>(output.size()));
+    payload += output;
+    putByte(payload, static_cast<unsigned char>(value.encoding));
+    payload += value.bytes;
+
+    std::string frame;
+    putU32(frame, static_cast<uint32_t>(payload.size()));
+    return frame + payload;
+}
+
+
+
+//
+// CAPTURED OUTPUT
+//
+
+//
+// What a script prints goes in the response, up to the response limit.
+// Past that it's counted as cut and dropped, so a script printing in a loop
+// doesn't run the worker out of memory.
+//
+
+class CappedBuffer : public std::streambuf {
+public:
+    explicit CappedBuffer (size_t limit) : limit (limit), cut (false) {}
+
+    std::string text;
+    size_t const limit;
+    bool cut;
+
+protected:
+    std::streamsize xsputn(char const * data, std::streamsize size) override {
+        size_t room = limit - text.size();
+        size_t wanted = static_cast<size_t>(size);
+        if (wanted > room) {
+            cut = true;
+            wanted = room;
+        }
+        text.append(data, wanted);
+        return size; // as if written, so PRINT doesn't fail
+    }
+
+    int_type overflow(int_type ch) override {
+        if (traits_type::eq_int_type(ch, traits_type::eof()))
+            return traits_type::not_eof(ch);
+
+        char c = traits_type::to_char_type(ch);
+        xsputn(&c, 1);
+        return ch;
+    }
+};
+
+
+
+//
+// WATCHDOG
+//
+
+//
+// A thread that halts the evaluation when a request runs past its time.
+// The halt is the runtime's cancel(), which is noticed between steps of the
+// evaluator; if it isn't noticed within the same time again, the worker
+// exits rather than stay stuck.
+//
+
+class Watchdog {
+public:
+    explicit Watchdog (std::chrono::seconds timeout) :
+        timeout (timeout),
+        armed (false),
+        fired (false),
+        stopping (false),
+        thread ([this]() { watch(); })
+    {
+    }
+
+    ~Watchdog () {
+        {
+            std::lock_guard<std::mutex> lock {mutex};
+            stopping = true;
+        }
+        changed.notify_one();
+        thread.join();
+    }
+
+    void arm() {
+        std::lock_guard<std::mutex> lock {mutex};
+        deadline = std::chrono::steady_clock::now() + timeout;
+        armed = true;
+        fired = false;
+        changed.notify_one();
+    }
+
+    // Says whether the halt was requested.  (Possibly just after the
+    // evaluation finished, in which case the halt is still pending.)
+    //
+    bool disarm() {
+        std::lock_guard<std::mutex> lock {mutex};
+        armed = false;
+        changed.notify_one();
+        return fired;
+    }
+
+private:
+    void watch() {
+        std::unique_lock<std::mutex> lock {mutex};
+        while (!stopping) {
+            if (!armed) {
+                changed.wait(lock);
+                continue;
+            }
+
+            changed.wait_until(lock, deadline);
+            if (stopping || !armed)
+                continue;
+            if (std::chrono::steady_clock::now() < deadline)
+                continue; // woken early, or rearmed for a later request
+
+            if (!fired) {
+                runtime.cancel();
+                fired = true;
+                deadline += timeout;
+                continue;
+            }
+
+            std::cerr << "ren-serve: worker " << getpid()
+                << " didn't halt, exiting" << std::endl;
+            _exit(EXIT_FAILURE);
+        }
+    }
+
+    std::chrono::seconds const timeout;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::chrono::steady_clock::time_point deadline;
+    bool armed;
+    bool fired;
+    bool stopping;
+
+    std::thread thread; // last, so it starts after the rest is set up
+};
+
+
+
+//
+// EVALUATION
+//
+
+std::string evaluate(
+    uint32_t id,
+    char const * script,
+    size_t size,
+    Options const & options,
+    Watchdog & watchdog
+) {
+    CappedBuffer captured {options.maxResponse};
+    std::ostream output {&captured};
+
+    Engine & engine = Engine::runFinder();
+    std::ostream & previous = engine.setOutputStream(output);
+
+    Status status;
+    Encoded value;
+
+    watchdog.arm();
+
+    try {
+        String source {std::string {script, size}};
+
+        Evaluation outcome = runtime.tryEvaluate({
+            "do bind/set load/all", source, "make object! []"
+        });
+
+        switch (outcome.status) {
+        case Evaluation::Status::Completed:
+            status = Status::Completed;
+            value = encodeValue(outcome.value, options.maxResponse);
+            break;
+
+        case Evaluation::Status::Thrown:
+            status = Status::Thrown;
+            value = encodeValue(outcome.value, options.maxResponse);
+            break;
+
+        case Evaluation::Status::Errored:
+            status = Status::Errored;
+            value = encodeText(to_string(*outcome.error), options.maxResponse);
+            break;
+
+        case Evaluation::Status::Halted:
+        default:
+            status = Status::TimedOut;
+            value = Encoded {Encoding::None, std::string {}, false};
+            break;
+        }
+    }
+    catch (std::exception const & e) {
+        // e.g. a load_error from text that isn't UTF-8
+        //
+        status = Status::Errored;
+        value = encodeText(e.what(), options.maxResponse);
+    }
+
+    if (watchdog.disarm() && status != Status::TimedOut) {
+        //
+        // The time ran out just as the evaluation finished.  Let the pending
+        // halt happen now, instead of in the next request.
+        //
+        runtime.tryEvaluate({"none"});
+    }
+
+    engine.setOutputStream(previous);
+
+    return responseFrame(id, status, captured.text, captured.cut, value);
+}
+
+
+
+//
+// CONNECTIONS
+//
+
+bool writeAll(int fd, std::string const & data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t size = write(fd, data.data() + written, data.size() - written);
+        if (size > 0)
+            written += static_cast<size_t>(size);
+        else if (size == -1 && errno != EINTR)
+            return false;
+    }
+    return true;
+}
+
+
+class Connection {
+public:
+    Connection (int fd, Options const & options, Watchdog & watchdog) :
+        fd (fd),
+        options (options),
+        watchdog (watchdog),
+        start (0)
+    {
+    }
+
+    void serve() {
+        for (;;) {
+            if (!buffered(4)) {
+                if (!flush() || !fill(4))
+                    return;
+            }
+
+            uint32_t length = getU32(input.data() + start);
+            if (length < 4 || length > options.maxRequest) {
+                std::ostringstream message;
+                message << "Request frame of " << length << " bytes, needs"
+                    << " 4 to " << options.maxRequest;
+
+                pending += responseFrame(
+                    0,
+                    Status::BadRequest,
+                    std::string {},
+                    false,
+                    encodeText(message.str(), options.maxResponse)
+                );
+                flush();
+                return;
+            }
+
+            size_t frameSize = 4 + static_cast<size_t>(length);
+            if (!buffered(frameSize)) {
+                if (!flush() || !fill(frameSize))
+                    return;
+            }
+
+            char const * frame = input.data() + start;
+            pending += evaluate(
+                getU32(frame + 4),
+                frame + 8,
+                length - 4,
+                options,
+                watchdog
+            );
+            start += frameSize;
+
+            // Pipelined requests that are already here are answered in one
+            // write, unless that builds up too much
+
+            if (pending.size() > 65536 && !flush())
+                return;
+        }
+    }
+
+private:
+    bool buffered(size_t size) const {
+        return input.size() - start >= size;
+    }
+
+    bool fill(size_t size) {
+        input.erase(0, start);
+        start = 0;
+
+        char chunk[65536];
+        while (input.size() < size) {
+            ssize_t got = read(fd, chunk, sizeof(chunk));
+            if (got > 0)
+                input.append(chunk, static_cast<size_t>(got));
+            else if (got == 0 || errno != EINTR)
+                return false; // closed (or broken) by the client
+        }
+        return true;
+    }
+
+    bool flush() {
+        bool ok = writeAll(fd, pending);
+        pending.clear();
+        return ok;
+    }
+
+    int fd;
+    Options const & options;
+    Watchdog & watchdog;
+
+    std::string input;
+    size_t start; // of the first unprocessed byte in `input`
+    std::string pending; // responses not yet written
+};
+
+
+
+//
+// WORKERS
+//
+
+void limitMemory(size_t megabytes) {
+    rlimit limit;
+    limit.rlim_cur = static_cast<rlim_t>(megabytes) * 1024 * 1024;
+    limit.rlim_max = limit.rlim_cur;
+    if (setrlimit(RLIMIT_AS, &limit) != 0)
+        std::cerr << "ren-serve: couldn't limit memory: "
+            << strerror(errno) << std::endl;
+}
+
+
+[[noreturn]] void runWorker(int listener, Options const & options) {
+    signal(SIGTERM, SIG_DFL);
+    signal(SIGINT, SIG_DFL);
+    signal(SIGPIPE, SIG_IGN); // a client going away is a failed write()
+
+    limitMemory(options.memoryMegabytes);
+
+    // Start the runtime before the first client is waiting on it
+
+    runtime("none");
+
+    Watchdog watchdog {options.timeout};
+
+    for (;;) {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd == -1) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            std::cerr << "ren-serve: accept() failed: "
+                << strerror(errno) << std::endl;
+            _exit(EXIT_FAILURE);
+        }
+
+        // A read or write that waits longer than this fails (EAGAIN), and
+        // the connection is closed like one the client broke
+
+        timeval idle;
+        idle.tv_sec = static_cast<time_t>(options.idle.count());
+        idle.tv_usec = 0;
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &idle, sizeof(idle));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &idle, sizeof(idle));
+
+        Connection connection {fd, options, watchdog};
+        connection.serve();
+        close(fd);
+    }
+}
+
+
+
+//
+// SUPERVISOR
+//
+
+volatile sig_atomic_t stopping = 0;
+
+void onStopSignal(int) {
+    stopping = 1;
+}
+
+
+int listenOn(std::string const & path) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path))
+        throw std::runtime_error("socket path is too long: " + path);
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    sockaddr * generic = reinterpret_cast<sockaddr *>(&address);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1)
+        throw std::runtime_error(
+            std::string {"couldn't make a socket: "} + strerror(errno)
+        );
+
+    // A socket file left by a server that's gone is replaced, but not one
+    // that something is still listening on
+
+    if (connect(fd, generic, sizeof(address)) == 0) {
+        close(fd);
+        throw std::runtime_error("something is already serving " + path);
+    }
+    close(fd);
+    unlink(path.c_str());
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1)
+        throw std::runtime_error(
+            std::string {"couldn't make a socket: "} + strerror(errno)
+        );
+
+    mode_t previousMask = umask(0177); // owner read and write only
+    int bound = bind(fd, generic, sizeof(address));
+    umask(previousMask);
+
+    if (bound != 0 || listen(fd, SOMAXCONN) != 0) {
+        int failure = errno;
+        close(fd);
+        throw std::runtime_error(
+            "couldn't listen on " + path + ": " + strerror(failure)
+        );
+    }
+
+    return fd;
+}
+
+
+pid_t startWorker(int listener, Options const & options) {
+    pid_t pid = fork();
+    if (pid == 0)
+        runWorker(listener, options);
+    if (pid == -1)
+        std::cerr << "ren-serve: couldn't fork(): "
+            << strerror(errno) << std::endl;
+    return pid;
+}
+
+
+int supervise(int listener, Options const & options) {
+    using Clock = std::chrono::steady_clock;
+
+    std::map<pid_t, Clock::time_point> started;
+
+    while (!stopping) {
+        while (static_cast<int>(started.size()) < options.workers) {
+            pid_t pid = startWorker(listener, options);
+            if (pid == -1)
+                break;
+            started[pid] = Clock::now();
+        }
+
+        int status;
+        pid_t pid = wait(&status);
+        if (pid == -1) {
+            if (errno == ECHILD)
+                sleep(1); // no workers, as fork() is failing
+            continue; // (or interrupted by a signal, to check `stopping`)
+        }
+
+        auto found = started.find(pid);
+        if (found == started.end())
+            continue;
+
+        std::cerr << "ren-serve: worker " << pid;
+        if (WIFSIGNALED(status))
+            std::cerr << " killed by signal " << WTERMSIG(status);
+        else
+            std::cerr << " exited with status " << WEXITSTATUS(status);
+        std::cerr << ", replacing it" << std::endl;
+
+        // Don't spin if workers die as soon as they start
+
+        if (Clock::now() - found->second < std::chrono::seconds {1})
+            sleep(1);
+
+        started.erase(found);
+    }
+
+    for (auto const & worker : started)
+        kill(worker.first, SIGTERM);
+    for (auto const & worker : started)
+        waitpid(worker.first, nullptr, 0);
+
+    return EXIT_SUCCESS;
+}
+
+} // end anonymous namespace
+
+
+
+//
+// MAIN
+//
+
+int main(int argc, char * argv[]) {
+    Options options;
+    int listener;
+
+    try {
+        options = parseOptions(argc, argv);
+        listener = listenOn(options.socketPath);
+    }
+    catch (std::exception const & e) {
+        std::cerr << "ren-serve: " << e.what() << "\n" << usage;
+        return EXIT_FAILURE;
+    }
+
+    // No SA_RESTART, so wait() returns to check `stopping`
+
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = &onStopSignal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGTERM, &action, nullptr);
+    sigaction(SIGINT, &action, nullptr);
+
+    int result = supervise(listener, options);
+
+    close(listener);
+    unlink(options.socketPath.c_str());
+    return result;
+}